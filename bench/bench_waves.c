@@ -0,0 +1,448 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+#include <SDL2/SDL.h>
+
+#include "sdl_wrapper.h"
+#include "scene.h"
+#include "body.h"
+#include "global_body_info.h"
+#include "path.h"
+#include "tower.h"
+#include "virus.h"
+#include "bullet.h"
+#include "shop.h"
+#include "sound.h"
+#include "wave.h"
+
+// Runs every wave of waves.txt on each path with a fixed tower layout, headless,
+// and writes ns/tick, allocations/tick and peak live bodies per wave as JSON.
+// Usage: bench_waves [--ticks N] [--repeat N] [--out FILE] [--baseline FILE] [--tolerance FRACTION]
+// Each wave is run --repeat times and the median time is kept, to filter out noise from the machine.
+// With --baseline, exits with 1 if the baseline is missing, or if any wave allocates more than it did
+// or has no baseline. Allocation counts are deterministic, but times vary from run to run and machine
+// to machine, so waves more than --tolerance slower are only reported.
+
+const double BENCH_WINDOW_WIDTH = 1000;
+const double BENCH_WINDOW_HEIGHT = 500;
+const double BENCH_PLAYING_WIDTH = 770;
+const double BENCH_PLAYING_HEIGHT = 450;
+const double BENCH_STEP = 1.0 / 60.0;
+const size_t DEFAULT_BENCH_TICKS = 1200;
+const size_t DEFAULT_BENCH_REPEATS = 5;
+const unsigned int BENCH_SEED = 42;
+const char WAVES_FILENAME[] = "waves.txt";
+const double DEFAULT_TIME_TOLERANCE = 0.25;
+const double ALLOC_ROUNDING = 0.0005; // allocs_per_tick is written with 3 decimals
+const double NS_PER_S = 1e9;
+const double BENCH_WALL_MASS = INFINITY;
+const rgb_color_t BENCH_WALL_COLOR = {.r = 0.0, .g = 0.0, .b = 0.0};
+const int BENCH_MONEY = 1000000;
+const char DEFAULT_OUT_FILENAME[] = "out/bench_waves.json";
+
+typedef struct bench_tower
+{
+    tower_id_t id;
+    vector_t position;
+} bench_tower_t;
+
+typedef struct bench_path
+{
+    const char *name;
+    draw_path_func_t draw_path;
+    const bench_tower_t *towers;
+    size_t num_towers;
+} bench_path_t;
+
+typedef struct bench_result
+{
+    char name[64];
+    size_t ticks;
+    double ns_per_tick;
+    double allocs_per_tick; // negative if allocations can't be counted on this platform
+    size_t peak_bodies;
+} bench_result_t;
+
+// the same kinds of tower on every path, placed off the path between its lanes
+const bench_tower_t SIMPLE_PATH_TOWERS[] = {
+    {.id = DART_TOWER_ID, .position = {.x = 150, .y = 230}},
+    {.id = TACK_SHOOTER_ID, .position = {.x = 270, .y = 230}},
+    {.id = BOMB_SHOOTER_ID, .position = {.x = 390, .y = 230}},
+    {.id = BOOMERANG_ID, .position = {.x = 510, .y = 230}},
+    {.id = GLUE_TOWER_ID, .position = {.x = 630, .y = 230}},
+    {.id = SUPER_TOWER_ID, .position = {.x = 390, .y = 330}}};
+const bench_tower_t MEDIUM_PATH_TOWERS[] = {
+    {.id = DART_TOWER_ID, .position = {.x = 300, .y = 370}},
+    {.id = TACK_SHOOTER_ID, .position = {.x = 500, .y = 370}},
+    {.id = BOMB_SHOOTER_ID, .position = {.x = 300, .y = 290}},
+    {.id = BOOMERANG_ID, .position = {.x = 500, .y = 290}},
+    {.id = GLUE_TOWER_ID, .position = {.x = 300, .y = 150}},
+    {.id = SUPER_TOWER_ID, .position = {.x = 500, .y = 150}}};
+const bench_tower_t COMPLEX_PATH_TOWERS[] = {
+    {.id = DART_TOWER_ID, .position = {.x = 400, .y = 370}},
+    {.id = TACK_SHOOTER_ID, .position = {.x = 300, .y = 270}},
+    {.id = BOMB_SHOOTER_ID, .position = {.x = 500, .y = 270}},
+    {.id = BOOMERANG_ID, .position = {.x = 650, .y = 270}},
+    {.id = GLUE_TOWER_ID, .position = {.x = 300, .y = 90}},
+    {.id = SUPER_TOWER_ID, .position = {.x = 500, .y = 90}}};
+
+#ifdef BENCH_WRAP_MALLOC
+// linked with -Wl,--wrap=malloc etc., so every allocation made by the engine and game goes through here
+size_t allocation_count = 0;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size)
+{
+    allocation_count++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size)
+{
+    allocation_count++;
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    allocation_count++;
+    return __real_realloc(ptr, size);
+}
+#endif
+
+// PRIVATE HELPER FUNCTION DECLARATIONS
+size_t get_allocation_count(void);
+void bench_build_walls(scene_t *scene);
+void bench_place_towers(game_state_t *game_state, const bench_path_t *path);
+bench_result_t bench_wave(const bench_path_t *path, wave_table_t *waves, int wave, size_t ticks);
+void write_results(FILE *f, const bench_result_t *results, size_t num_results, size_t ticks);
+size_t read_results(const char *filename, bench_result_t *results, size_t max_results);
+bool compare_results(const bench_result_t *results, size_t num_results,
+                     const bench_result_t *baseline, size_t num_baseline, double tolerance);
+int compare_doubles(const void *d1, const void *d2);
+
+size_t get_allocation_count(void)
+{
+#ifdef BENCH_WRAP_MALLOC
+    return allocation_count;
+#else
+    return 0;
+#endif
+}
+
+void bench_build_walls(scene_t *scene)
+{
+    // same walls as the game, so bullets leaving the playing area are removed
+    double radius = bullet_get_radius();
+    double width = BENCH_PLAYING_WIDTH;
+    double height = BENCH_PLAYING_HEIGHT;
+    list_t *shapes[] = {polygon_make_rectangle(-1.0 * radius, 0, 0, height),
+                        polygon_make_rectangle(width, 0, width + radius, height),
+                        polygon_make_rectangle(-1.0 * radius, height, width + radius, height + radius),
+                        polygon_make_rectangle(-1.0 * radius, -1.0 * radius, width + radius, 0)};
+    for (size_t i = 0; i < sizeof(shapes) / sizeof(shapes[0]); i++)
+    {
+        body_t *wall = body_init_with_secondary_info(shapes[i], BENCH_WALL_MASS, BENCH_WALL_COLOR,
+                                                     NULL, NULL, WALL_TYPE);
+        scene_add_body(scene, wall);
+    }
+}
+
+void bench_place_towers(game_state_t *game_state, const bench_path_t *path)
+{
+    for (size_t i = 0; i < path->num_towers; i++)
+    {
+        // same checks as placing the tower from the shop
+        tower_id_t id = path->towers[i].id;
+        game_state->last_clicked_item_type = SHOP_TYPE;
+        game_state->global_shop_item_selected = TOWER_TYPE;
+        game_state->specific_shop_item_selected = id;
+        game_state->purchased_item_cost = tower_get_from_id(id).price;
+        shop_place_item(game_state, path->towers[i].position, BENCH_PLAYING_WIDTH, BENCH_PLAYING_HEIGHT);
+    }
+
+    size_t num_towers = list_size(scene_get_bodies_of_type(game_state->scene, TOWER_TYPE));
+    if (num_towers != path->num_towers)
+    {
+        fprintf(stderr, "%s: only %zu of %zu towers could be placed\n", path->name, num_towers, path->num_towers);
+    }
+}
+
+bench_result_t bench_wave(const bench_path_t *path, wave_table_t *waves, int wave, size_t ticks)
+{
+    // every run of a wave plays out exactly the same
+    srand(BENCH_SEED);
+    scene_t *scene = scene_init();
+    game_state_t game_state = {.scene = scene, .money = BENCH_MONEY, .health = BENCH_MONEY,
+                               .level = wave, .score = 0, .last_clicked_item_type = NOTHING,
+                               .last_tower_selected = BODY_HANDLE_NONE, .shop_item_preview = BODY_HANDLE_NONE, .path = NULL,
+                               .waves = waves, .global_shop_item_selected = NOTHING,
+                               .specific_shop_item_selected = NOT_TOWER, .purchased_item_cost = 0,
+                               .screen = PLAYING_SCREEN, .pop_sound = sound_init("sounds/pop.wav", 0),
+                               .purchase_sound = sound_init("sounds/purchased.wav", 0),
+                               .win_sound = NULL, .lose_sound = NULL, .shop_description = NULL,
+                               .help_image = NULL, .virus_count = 0};
+    virus_add_collision_rules(scene, &game_state);
+    bullet_add_collision_rules(scene, &game_state);
+    game_state.path = path->draw_path(scene, BENCH_WINDOW_HEIGHT);
+    bench_build_walls(scene);
+    bench_place_towers(&game_state, path);
+    load_wave(wave, scene, &game_state);
+
+    bench_result_t result;
+    snprintf(result.name, sizeof(result.name), "%s/wave_%02d", path->name, wave);
+    result.ticks = ticks;
+    result.peak_bodies = scene_bodies(scene);
+
+#ifdef BENCH_WRAP_MALLOC
+    size_t start_allocations = get_allocation_count();
+#endif
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (size_t tick = 0; tick < ticks; tick++)
+    {
+        // the game's per-step update, without the player info text
+        tower_index_viruses(scene);
+        list_t *viruses = scene_get_bodies_of_type(scene, VIRUS_TYPE);
+        for (size_t i = 0; i < list_size(viruses); i++)
+        {
+            virus_tick(list_get(viruses, i), game_state.path, BENCH_STEP);
+        }
+        list_t *towers = scene_get_bodies_of_type(scene, TOWER_TYPE);
+        for (size_t i = 0; i < list_size(towers); i++)
+        {
+            tower_tick(list_get(towers, i), scene, &game_state);
+        }
+        list_t *bullets = scene_get_bodies_of_type(scene, BULLET_TYPE);
+        for (size_t i = 0; i < list_size(bullets); i++)
+        {
+            bullet_tick(list_get(bullets, i));
+        }
+        wave_tick(scene, &game_state, BENCH_STEP);
+        game_state.virus_count = (int)(list_size(viruses) + game_state.spawner.remaining);
+        scene_tick(scene, BENCH_STEP);
+
+        if (scene_bodies(scene) > result.peak_bodies)
+        {
+            result.peak_bodies = scene_bodies(scene);
+        }
+    }
+    Uint64 elapsed = SDL_GetPerformanceCounter() - start;
+
+    result.ns_per_tick = (double)elapsed * NS_PER_S / SDL_GetPerformanceFrequency() / ticks;
+#ifdef BENCH_WRAP_MALLOC
+    size_t allocations = get_allocation_count() - start_allocations;
+    result.allocs_per_tick = (double)allocations / ticks;
+#else
+    result.allocs_per_tick = -1.0;
+#endif
+
+    scene_free(scene);
+    sound_free(game_state.pop_sound);
+    sound_free(game_state.purchase_sound);
+    return result;
+}
+
+void write_results(FILE *f, const bench_result_t *results, size_t num_results, size_t ticks)
+{
+    // one benchmark per line, which read_results() relies on
+    fprintf(f, "{\n  \"ticks_per_wave\": %zu,\n  \"benchmarks\": [\n", ticks);
+    for (size_t i = 0; i < num_results; i++)
+    {
+        fprintf(f, "    {\"name\": \"%s\", \"ticks\": %zu, \"ns_per_tick\": %.1f, "
+                   "\"allocs_per_tick\": %.3f, \"peak_bodies\": %zu}%s\n",
+                results[i].name, results[i].ticks, results[i].ns_per_tick,
+                results[i].allocs_per_tick, results[i].peak_bodies, i + 1 < num_results ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+}
+
+size_t read_results(const char *filename, bench_result_t *results, size_t max_results)
+{
+    FILE *f = fopen(filename, "r");
+    if (f == NULL)
+    {
+        return 0;
+    }
+    size_t num_results = 0;
+    char line[256];
+    while (num_results < max_results && fgets(line, sizeof line, f) != NULL)
+    {
+        bench_result_t *result = &results[num_results];
+        if (sscanf(line, " {\"name\": \"%63[^\"]\", \"ticks\": %zu, \"ns_per_tick\": %lf, "
+                         "\"allocs_per_tick\": %lf, \"peak_bodies\": %zu}",
+                   result->name, &result->ticks, &result->ns_per_tick,
+                   &result->allocs_per_tick, &result->peak_bodies) == 5)
+        {
+            num_results++;
+        }
+    }
+    fclose(f);
+    return num_results;
+}
+
+int compare_doubles(const void *d1, const void *d2)
+{
+    double x1 = *(const double *)d1;
+    double x2 = *(const double *)d2;
+    return (x1 > x2) - (x1 < x2);
+}
+
+bool compare_results(const bench_result_t *results, size_t num_results,
+                     const bench_result_t *baseline, size_t num_baseline, double tolerance)
+{
+    bool passed = true;
+    for (size_t i = 0; i < num_results; i++)
+    {
+        const bench_result_t *result = &results[i];
+        const bench_result_t *base = NULL;
+        for (size_t j = 0; j < num_baseline; j++)
+        {
+            if (strcmp(baseline[j].name, result->name) == 0 && baseline[j].ticks == result->ticks)
+            {
+                base = &baseline[j];
+                break;
+            }
+        }
+        if (base == NULL)
+        {
+            printf("MISSING %s: no baseline for %zu ticks, record one with make bench-baseline\n",
+                   result->name, result->ticks);
+            passed = false;
+            continue;
+        }
+
+        if (result->ns_per_tick > base->ns_per_tick * (1 + tolerance))
+        {
+            // timing is too noisy to fail on, so only warn
+            printf("slower %s: %.1f ns/tick, baseline %.1f\n", result->name,
+                   result->ns_per_tick, base->ns_per_tick);
+        }
+        if (result->allocs_per_tick >= 0 && base->allocs_per_tick >= 0 &&
+            result->allocs_per_tick > base->allocs_per_tick + ALLOC_ROUNDING)
+        {
+            printf("REGRESSION %s: %.3f allocs/tick, baseline %.3f\n", result->name,
+                   result->allocs_per_tick, base->allocs_per_tick);
+            passed = false;
+        }
+        if (result->peak_bodies != base->peak_bodies)
+        {
+            // not a slowdown, but the simulation itself behaves differently
+            printf("note %s: peak of %zu bodies, baseline %zu\n", result->name,
+                   result->peak_bodies, base->peak_bodies);
+        }
+    }
+    return passed;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t ticks = DEFAULT_BENCH_TICKS;
+    size_t repeats = DEFAULT_BENCH_REPEATS;
+    double tolerance = DEFAULT_TIME_TOLERANCE;
+    const char *out_filename = DEFAULT_OUT_FILENAME;
+    const char *baseline_filename = NULL;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--ticks") == 0)
+        {
+            ticks = (size_t)atol(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--repeat") == 0)
+        {
+            repeats = (size_t)atol(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--tolerance") == 0)
+        {
+            tolerance = atof(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--out") == 0)
+        {
+            out_filename = argv[i + 1];
+        }
+        else if (strcmp(argv[i], "--baseline") == 0)
+        {
+            baseline_filename = argv[i + 1];
+        }
+    }
+    assert(ticks > 0);
+    assert(repeats > 0);
+
+    sdl_init_headless(VEC_ZERO, (vector_t){.x = BENCH_WINDOW_WIDTH, .y = BENCH_WINDOW_HEIGHT}, BENCH_STEP);
+    setup_tower_configs();
+    wave_table_t *waves = wave_table_init(WAVES_FILENAME);
+    assert(waves != NULL);
+    size_t num_waves = wave_table_size(waves);
+
+    const bench_path_t paths[] = {
+        {.name = "simple_path", .draw_path = draw_simple_path, .towers = SIMPLE_PATH_TOWERS,
+         .num_towers = sizeof(SIMPLE_PATH_TOWERS) / sizeof(SIMPLE_PATH_TOWERS[0])},
+        {.name = "medium_path", .draw_path = draw_medium_path, .towers = MEDIUM_PATH_TOWERS,
+         .num_towers = sizeof(MEDIUM_PATH_TOWERS) / sizeof(MEDIUM_PATH_TOWERS[0])},
+        {.name = "complex_path", .draw_path = draw_complex_path, .towers = COMPLEX_PATH_TOWERS,
+         .num_towers = sizeof(COMPLEX_PATH_TOWERS) / sizeof(COMPLEX_PATH_TOWERS[0])}};
+    size_t num_paths = sizeof(paths) / sizeof(paths[0]);
+    size_t max_results = num_paths * num_waves;
+    bench_result_t *results = malloc(max_results * sizeof(bench_result_t));
+    assert(results != NULL);
+    double *times = malloc(repeats * sizeof(double));
+    assert(times != NULL);
+
+    size_t num_results = 0;
+    for (size_t p = 0; p < num_paths; p++)
+    {
+        for (size_t wave = 0; wave < num_waves; wave++)
+        {
+            results[num_results] = bench_wave(&paths[p], waves, (int)wave, ticks);
+            times[0] = results[num_results].ns_per_tick;
+            for (size_t r = 1; r < repeats; r++)
+            {
+                times[r] = bench_wave(&paths[p], waves, (int)wave, ticks).ns_per_tick;
+            }
+            qsort(times, repeats, sizeof(double), compare_doubles);
+            results[num_results].ns_per_tick = times[repeats / 2];
+            fprintf(stderr, "%-24s %10.1f ns/tick %8.3f allocs/tick %5zu peak bodies\n",
+                    results[num_results].name, results[num_results].ns_per_tick,
+                    results[num_results].allocs_per_tick, results[num_results].peak_bodies);
+            num_results++;
+        }
+    }
+
+    FILE *f = fopen(out_filename, "w");
+    assert(f != NULL);
+    write_results(f, results, num_results, ticks);
+    fclose(f);
+    printf("wrote %s\n", out_filename);
+
+    int status = 0;
+    if (baseline_filename != NULL)
+    {
+        bench_result_t *baseline = malloc(max_results * sizeof(bench_result_t));
+        assert(baseline != NULL);
+        size_t num_baseline = read_results(baseline_filename, baseline, max_results);
+        if (num_baseline == 0)
+        {
+            printf("no baseline in %s, record one with make bench-baseline\n", baseline_filename);
+            status = 1;
+        }
+        else if (compare_results(results, num_results, baseline, num_baseline, tolerance))
+        {
+            printf("no regressions against %s\n", baseline_filename);
+        }
+        else
+        {
+            status = 1;
+        }
+        free(baseline);
+    }
+
+    free(times);
+    free(results);
+    wave_table_free(waves);
+    sdl_cleanup();
+    return status;
+}
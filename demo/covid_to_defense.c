@@ -24,6 +24,9 @@
 #include "global_body_info.h"
 #include "tool.h"
 #include "sound.h"
+#include "wave.h"
+#include "profile.h"
+#include "arena.h"
 
 //////////////////////// CONSTS AND CONFIGURATION //////////////////////////////
 
@@ -31,6 +34,10 @@ const int DEMO_WINDOW_WIDTH = 1000;
 const int DEMO_WINDOW_HEIGHT = 500;
 const double DEMO_PLAYING_WIDTH = 770;  // DEMO_WINDOW_WIDTH - MENU_WIDTH
 const double DEMO_PLAYING_HEIGHT = 450; // DEMO_WINDOW_HEIGHT - PLAYER_INFO_HEIGHT
+
+// simulation runs at a fixed rate regardless of frame rate
+const double SIM_STEP = 1.0 / 60.0;
+const size_t MAX_CATCH_UP_STEPS = 5;
 const rgb_color_t CTD_FONT_COLOR = {.r = (float)0.0, .g = (float)0.0, .b = (float)0.0};
 const int NUM_LOOPS = 10;
 
@@ -40,10 +47,14 @@ const int INITIAL_HEALTH = 200;
 const int INITIAL_SCORE = 0;
 const int INITIAL_LEVEL = 0;
 const int MAX_LEVEL = 30;
+const char WAVES_FILENAME[] = "waves.txt";
+const char PRECOMPILED_WAVES_FILENAME[] = "waves.bin"; // used instead of waves.txt while newer than it
+const char WRITE_WAVES_FLAG[] = "--write-waves";      // writes waves.bin from waves.txt and exits, see "make waves.bin"
 
 // player info area
 const double PLAYER_INFO_HEIGHT = 50;
 const int PLAYER_INFO_FONT_SIZE = 70;
+const size_t MAX_PLAYER_INFO_LENGTH = 100; // same as the text buffer allocated by text_init()
 
 // walls
 const double GAME_WALL_MASS = INFINITY;
@@ -56,14 +67,10 @@ const rgb_color_t SHOP_MENU_COLOR = {.r = (float)0.60, .g = (float)0.60, .b = (f
 const rgb_color_t UPGRADE_MENU_COLOR = {.r = (float)0.50, .g = (float)0.50, .b = (float)0.50};
 const int UPGRADES_FONT_SIZE = 50;
 
-// viruses
-const double VIRUS_SPACING = 15;
-const vector_t VIRUS_START_POSITION = {.x = 100, .y = 410};
-const vector_t VIRUS_SPEED = {.x = 100, .y = 0};
-
 // mouse
 const double MOUSE_RANGE = 2;
 const size_t MOUSE_NUM_POINTS = 15;
+const size_t DEFAULT_CLICKABLE_BODIES = 4;
 
 // next wave button
 const vector_t NEXT_WAVE_BUTTON1 = {.x = 800, .y = 450};
@@ -105,12 +112,52 @@ const double GAMEOVER_SCREEN_RESTART_BTN_OFFSET = 150;
 const double GAMEOVER_SCREEN_QUIT_BTN_OFFSET = 200;
 const double CONFETTI_ELASTICITY = 1.0;
 
+// fonts opened at startup so screen changes and shop clicks don't hit the disk
+const char *const PRELOAD_FONT_PATHS[] = {"fonts/futura.ttf", "fonts/futura.ttf", "fonts/futura.ttf",
+                                          "fonts/futura.ttf", "fonts/airstrike.ttf", "fonts/airstrike.ttf",
+                                          "fonts/TitilliumWeb-SemiBold.ttf", "fonts/adventure.ttf",
+                                          "fonts/MontereyFLF.ttf", "fonts/HighlandGothicFLF.ttf",
+                                          "fonts/CelticHand.ttf", "fonts/CelticHand.ttf",
+                                          "fonts/MotionPicture.ttf"};
+const int PRELOAD_FONT_SIZES[] = {50, 70, 100, 150, 100, 130, 90, 100, 100, 150, 150, 100, 150};
+
+#ifdef CTD_PROFILE
+// profiler overlay in the top left corner of the playing area, one line per zone
+const profile_zone_t OVERLAY_ZONES[] = {PROFILE_SCENE_TICK, PROFILE_TOWER_TICK, PROFILE_FIND_COLLISION,
+                                        PROFILE_RENDER, PROFILE_RENDER_TEXT};
+const vector_t OVERLAY_POSITION = {.x = 100, .y = 440};
+const vector_t OVERLAY_LINE_SIZE = {.x = 180, .y = 16};
+const int OVERLAY_FONT_SIZE = 50;
+const size_t OVERLAY_UPDATE_FRAMES = 30; // rasterizing the lines every frame would show up in the profile
+const char PROFILE_TRACE_PATH[] = "out/ctd_profile.json";
+#endif
+
+#ifdef CTD_HEADLESS
+// headless run: towers are bought before the listed wave, then every wave is played in order
+typedef struct scripted_tower
+{
+    int wave;
+    tower_id_t id;
+    vector_t position;
+} scripted_tower_t;
+
+const double HEADLESS_MS_PER_S = 1e3;
+const size_t HEADLESS_MAX_WAVE_TICKS = 60 * 60 * 5; // five simulated minutes
+const scripted_tower_t HEADLESS_TOWERS[] = {
+    {.wave = 0, .id = DART_TOWER_ID, .position = {.x = 200, .y = 230}},
+    {.wave = 0, .id = DART_TOWER_ID, .position = {.x = 350, .y = 230}},
+    {.wave = 3, .id = DART_TOWER_ID, .position = {.x = 500, .y = 230}},
+    {.wave = 6, .id = TACK_SHOOTER_ID, .position = {.x = 650, .y = 230}},
+    {.wave = 8, .id = DART_TOWER_ID, .position = {.x = 350, .y = 320}}};
+#endif
+
 //////////////////////////// FUNCTION DECLARATIONS //////////////////////////////////
 
-game_state_t initial_game_state(scene_t *scene);
+wave_table_t *load_waves(void);
+bool write_precompiled_waves(void);
+game_state_t initial_game_state(scene_t *scene, wave_table_t *waves);
 void covid_mouse_handler(mouse_event_type_t type, vector_t mouse_pos, game_state_t *game_state);
 void covid_key_handler(char key, key_event_type_t type);
-int load_wave(int n, scene_t *scene, game_state_t *game_state);
 void create_game_wall(game_state_t *game_state, double x1, double y1, double x2, double y2);
 void build_walls(game_state_t *game_state, double window_height, double window_width);
 void build_game_walls(game_state_t *game_state);
@@ -125,10 +172,42 @@ void start_game(game_state_t *game_state, draw_path_func_t draw_path);
 void game_over_screen(game_state_t *game_state);
 void make_simple_img_body(scene_t *scene, vector_t position, vector_t img_size, char *img_path);
 void make_quit_button(scene_t *scene, vector_t point1, vector_t point2, rgb_color_t quit_button_color);
+void tick_playing_screen(game_state_t *game_state);
+#ifdef CTD_PROFILE
+list_t *add_profile_overlay(void);
+void update_profile_overlay(list_t *lines);
+#endif
+#ifdef CTD_HEADLESS
+void headless_place_tower(game_state_t *game_state, tower_id_t id, vector_t position);
+#endif
 
 ///////////////////////////////////// FUNCTIONS ///////////////////////////////////////////
 
-game_state_t initial_game_state(scene_t *scene)
+wave_table_t *load_waves(void)
+{
+    wave_table_t *waves = wave_table_load(WAVES_FILENAME, PRECOMPILED_WAVES_FILENAME);
+    assert(waves != NULL);
+    return waves;
+}
+
+bool write_precompiled_waves(void)
+{
+    wave_table_t *waves = wave_table_init(WAVES_FILENAME);
+    if (waves == NULL)
+    {
+        printf("can't read %s \n", WAVES_FILENAME);
+        return false;
+    }
+    bool written = wave_table_write(waves, PRECOMPILED_WAVES_FILENAME);
+    if (!written)
+    {
+        printf("can't write %s \n", PRECOMPILED_WAVES_FILENAME);
+    }
+    wave_table_free(waves);
+    return written;
+}
+
+game_state_t initial_game_state(scene_t *scene, wave_table_t *waves)
 {
     sound_t *pop_sound = sound_init("sounds/pop.wav", 0);
     sound_t *purchase_sound = sound_init("sounds/purchased.wav", 0);
@@ -137,68 +216,14 @@ game_state_t initial_game_state(scene_t *scene)
 
     return (game_state_t){.scene = scene, .money = INITIAL_MONEY, .health = INITIAL_HEALTH,
         .level = 0, .score = 0, .last_clicked_item_type = NOTHING,
-        .last_tower_selected = NULL, .global_shop_item_selected = NOTHING,
+        .last_tower_selected = BODY_HANDLE_NONE, .shop_item_preview = BODY_HANDLE_NONE, .path = NULL,
+        .waves = waves, .global_shop_item_selected = NOTHING,
         .specific_shop_item_selected = NOT_TOWER, .purchased_item_cost = 0,
         .screen = WELCOME_SCREEN, .pop_sound = pop_sound, .purchase_sound = purchase_sound,
         .win_sound = win_sound, .lose_sound = lose_sound, .shop_description = NULL,
         .help_image = NULL, .virus_count = 0};
 }
 
-int load_wave(int n, scene_t *scene, game_state_t *game_state)
-{
-    // each number in waves.txt represents the health of a virus
-    // each line represents one wave of viruses
-    // nth line of file is the wave being rendered
-
-    FILE *f = fopen("waves.txt", "r");
-    int line_count = 0;
-    char line[1000];
-
-    int total_health = 0;
-
-    while (fgets(line, sizeof line, f) != NULL)
-    {
-        if (line_count == n)
-        {
-            for (size_t i = 0; i < strlen(line) - 1; i++) // character count
-            {
-                // converting alphabet to number
-                if (line[i] != ' ')
-                {
-                    int health = line[i] - 'a' + 1;
-                    vector_t pos = {VIRUS_START_POSITION.x - VIRUS_SPACING * (i + 1), VIRUS_START_POSITION.y};
-                    vector_t speed = VIRUS_SPEED;
-                    if (i < strlen(line) - 2)
-                    {
-                        if (isdigit(line[i + 1]))
-                        {
-                            speed = vec_multiply(1 + (line[i + 1] - '0') / 10.0, speed);
-                            i++;
-                        }
-                    }
-                    if (line[i] == '!')
-                    {
-                        create_virus(scene, 40, speed, pos, game_state, true);
-                        total_health += SUPER_VIRUS_HEALTH + SUPER_VIRUS_SPAWN_COUNT * SUPER_VIRUS_SPAWN_HEALTH;
-                    }
-                    else if (health > 0 && health <= 26)
-                    {
-                        create_virus(scene, health, speed, pos, game_state, false);
-                        total_health += health;
-                    }
-                }
-            }
-            line_count++;
-        }
-        else
-        {
-            line_count++;
-        }
-    }
-    fclose(f);
-    return total_health;
-}
-
 void covid_key_handler(char key, key_event_type_t type)
 {
     if (type == KEY_PRESSED)
@@ -218,16 +243,31 @@ void covid_mouse_handler(mouse_event_type_t type, vector_t mouse_pos, game_state
     mouse_pos = (vector_t){.x = mouse_pos.x, .y = DEMO_WINDOW_HEIGHT - mouse_pos.y};
     if (type == MOUSE_PRESSED)
     {
-        list_t *mouse = polygon_make_circle(mouse_pos, MOUSE_RANGE * 2, MOUSE_NUM_POINTS);
+        // the click area only lives until the click is handled
+        arena_mark_t mark = arena_mark(frame_arena());
+        polygon_t mouse_area = {.points = arena_alloc(frame_arena(), MOUSE_NUM_POINTS * sizeof(vector_t)),
+                                .size = MOUSE_NUM_POINTS};
+        for (size_t i = 0; i < MOUSE_NUM_POINTS; i++)
+        {
+            double angle = 2 * M_PI * i / MOUSE_NUM_POINTS;
+            mouse_area.points[i] = vec_add(mouse_pos, vec_multiply(MOUSE_RANGE * 2,
+                                                                   (vector_t){.x = cos(angle), .y = sin(angle)}));
+        }
+        polygon_t *mouse = &mouse_area;
+        // everything that can be clicked on is static
+        list_t *clickable = list_init(DEFAULT_CLICKABLE_BODIES, NULL);
+        scene_query_static(game_state->scene, mouse_pos, MOUSE_RANGE * 2, clickable);
         undisplay_help(game_state);
         shop_undisplay_description(game_state);
 
         if (game_state->last_clicked_item_type == NOTHING)
         {
-            for (size_t i = 0; i < scene_bodies(game_state->scene); i++)
+            for (size_t i = 0; i < list_size(clickable); i++)
             {
-                body_t *curr_body = scene_get_body(game_state->scene, i);
-                collision_info_t c = find_collision(mouse, body_get_shape(curr_body));
+                body_t *curr_body = list_get(clickable, i);
+                size_t shape_size;
+                const vector_t *shape = body_peek_shape(curr_body, &shape_size);
+                collision_info_t c = find_collision_points(mouse->points, mouse->size, shape, shape_size);
                 global_body_type_t type = get_global_type(curr_body);
                 if (c.collided)
                 {
@@ -307,14 +347,17 @@ void covid_mouse_handler(mouse_event_type_t type, vector_t mouse_pos, game_state
         }
         else if (game_state->last_clicked_item_type == TOWER_TYPE)
         {
-            for (size_t i = 0; i < scene_bodies(game_state->scene); i++)
+            // NULL if the selected tower was removed since it was clicked
+            body_t *tower_body = body_from_handle(game_state->last_tower_selected);
+            for (size_t i = 0; i < list_size(clickable); i++)
             {
-                body_t *curr_body = scene_get_body(game_state->scene, i);
-                collision_info_t c = find_collision(mouse, body_get_shape(curr_body));
+                body_t *curr_body = list_get(clickable, i);
+                size_t shape_size;
+                const vector_t *shape = body_peek_shape(curr_body, &shape_size);
+                collision_info_t c = find_collision_points(mouse->points, mouse->size, shape, shape_size);
                 global_body_type_t type = get_global_type(curr_body);
-                if (type == UPGRADE_BUTTON_TYPE && c.collided)
+                if (type == UPGRADE_BUTTON_TYPE && c.collided && tower_body != NULL)
                 {
-                    body_t *tower_body = game_state->last_tower_selected;
                     shop_purchase_tower_upgrade(tower_body, game_state);
                     tower_display_range(tower_body, game_state->scene);
                     break;
@@ -327,22 +370,15 @@ void covid_mouse_handler(mouse_event_type_t type, vector_t mouse_pos, game_state
         else if (game_state->last_clicked_item_type == SHOP_TYPE)
         {
             shop_place_item(game_state, mouse_pos, DEMO_PLAYING_WIDTH, DEMO_PLAYING_HEIGHT);
-            body_t *b = NULL;
-            for (size_t i = 0; i < scene_bodies(game_state->scene); i++)
-            {
-                body_t *curr_body = scene_get_body(game_state->scene, i);
-                if (get_global_type(curr_body) == MOUSE_TYPE)
-                {
-                    b = curr_body;
-                    break;
-                }
-            }
+            body_t *b = body_from_handle(game_state->shop_item_preview);
             if (b != NULL)
             {
                 body_remove(b);
             }
+            game_state->shop_item_preview = BODY_HANDLE_NONE;
         }
-        list_free(mouse);
+        list_free(clickable);
+        arena_rewind(frame_arena(), mark);
     }
     else
     {
@@ -359,7 +395,7 @@ void create_game_wall(game_state_t *game_state, double x1, double y1, double x2,
     list_t *shape = polygon_make_rectangle(x1, y1, x2, y2);
     body_t *wall = body_init_with_secondary_info(shape, GAME_WALL_MASS, GAME_WALL_COLOR,
                                                  NULL, NULL, WALL_TYPE);
-    scene_add_body(scene, wall);
+    scene_add_static_body(scene, wall);
 }
 
 void build_walls(game_state_t *game_state, double window_height, double window_width)
@@ -422,12 +458,12 @@ void play_game_screen(game_state_t *game_state)
                                                                 DEMO_WINDOW_HEIGHT);
     body_t *shop_menu = body_init_with_secondary_info(shop_menu_background_shape, INFINITY,
                                                       SHOP_MENU_COLOR, NULL, NULL, NOTHING);
-    scene_add_body(scene, shop_menu);
+    scene_add_static_body(scene, shop_menu);
 
     // Create health/score/level area
     list_t *player_info_background_shape = polygon_make_rectangle(0, DEMO_WINDOW_HEIGHT - PLAYER_INFO_HEIGHT,
                                                                   DEMO_PLAYING_WIDTH, DEMO_WINDOW_HEIGHT);
-    global_body_info_t *player_info_global = create_global_body_info(NULL, PLAYER_INFO_TYPE);
+    global_body_info_t *player_info_global = create_global_body_info(NULL);
     TTF_Font *info_font = create_font("fonts/futura.ttf", PLAYER_INFO_FONT_SIZE);
     vector_t player_info_text_size = (vector_t){DEMO_PLAYING_WIDTH, PLAYER_INFO_HEIGHT};
     char text[100];
@@ -438,19 +474,21 @@ void play_game_screen(game_state_t *game_state)
                                                                     player_info_global, NULL,
                                                                     text, CTD_FONT_COLOR, info_font,
                                                                     player_info_text_size);
-    scene_add_body(scene, player_info_background);
+    body_set_type(player_info_background, PLAYER_INFO_TYPE);
+    scene_add_static_body(scene, player_info_background);
 
     // Create next wave/level button
     list_t *button_shape = polygon_make_rectangle(NEXT_WAVE_BUTTON1.x, NEXT_WAVE_BUTTON1.y,
                                                   NEXT_WAVE_BUTTON2.x, NEXT_WAVE_BUTTON2.y);
-    global_body_info_t *next_wave_button_global_info = create_global_body_info(NULL, NEXT_WAVE_BUTTON_TYPE);
+    global_body_info_t *next_wave_button_global_info = create_global_body_info(NULL);
     TTF_Font *next_wave_button_font = create_font("fonts/airstrike.ttf", BUTTON_FONT_SIZE);
     body_t *next_wave_button = body_init_with_info_with_label(button_shape, BUTTON_MASS,
                                                               NEXT_WAVE_BUTTON_COLOR, next_wave_button_global_info,
                                                               NULL, "NEXT WAVE", CTD_FONT_COLOR, next_wave_button_font,
                                                               (vector_t){NEXT_WAVE_BUTTON2.x - NEXT_WAVE_BUTTON1.x,
                                                                          NEXT_WAVE_BUTTON2.y - NEXT_WAVE_BUTTON1.y});
-    scene_add_body(scene, next_wave_button);
+    body_set_type(next_wave_button, NEXT_WAVE_BUTTON_TYPE);
+    scene_add_static_body(scene, next_wave_button);
 
     // Create upgrades text area
     TTF_Font *upgrades_font = create_font("fonts/futura.ttf", UPGRADES_FONT_SIZE);
@@ -462,14 +500,15 @@ void play_game_screen(game_state_t *game_state)
     // Create help button
     list_t *button_shape2 = polygon_make_rectangle(HELP_BUTTON1.x, HELP_BUTTON1.y,
                                                    HELP_BUTTON2.x, HELP_BUTTON2.y);
-    global_body_info_t *help_button_global_info = create_global_body_info(NULL, HELP_BUTTON_TYPE);
+    global_body_info_t *help_button_global_info = create_global_body_info(NULL);
     TTF_Font *help_btn_font = create_font("fonts/TitilliumWeb-SemiBold.ttf", HELP_BTN_FONT_SIZE);
     body_t *help_button = body_init_with_info_with_label(button_shape2, BUTTON_MASS,
                                                          HELP_BUTTON_COLOR, help_button_global_info,
                                                          NULL, "HELP", CTD_FONT_COLOR, help_btn_font,
                                                          (vector_t){HELP_BUTTON2.x - HELP_BUTTON1.x,
                                                                     HELP_BUTTON2.y - HELP_BUTTON1.y});
-    scene_add_body(scene, help_button);
+    body_set_type(help_button, HELP_BUTTON_TYPE);
+    scene_add_static_body(scene, help_button);
 
     // Create quit game button
     make_quit_button(scene, QUIT_BUTTON1, QUIT_BUTTON2, QUIT_BUTTON_COLOR);
@@ -477,14 +516,15 @@ void play_game_screen(game_state_t *game_state)
     // Create back to main screen button
     list_t *menu_button_shape = polygon_make_rectangle(MENU_BUTTON1.x, MENU_BUTTON1.y,
                                                        MENU_BUTTON2.x, MENU_BUTTON2.y);
-    global_body_info_t *menu_button_global_info = create_global_body_info(NULL, MENU_BUTTON_TYPE);
+    global_body_info_t *menu_button_global_info = create_global_body_info(NULL);
     TTF_Font *adventure_font = create_font("fonts/adventure.ttf", BUTTON_FONT_SIZE);
     body_t *menu_button = body_init_with_info_with_label(menu_button_shape, BUTTON_MASS,
                                                          MENU_BUTTON_COLOR, menu_button_global_info, NULL,
                                                          "BACK TO MENU", CTD_FONT_COLOR, adventure_font,
                                                          (vector_t){MENU_BUTTON2.x - MENU_BUTTON1.x,
                                                                     MENU_BUTTON2.y - MENU_BUTTON1.y});
-    scene_add_body(scene, menu_button);
+    body_set_type(menu_button, MENU_BUTTON_TYPE);
+    scene_add_static_body(scene, menu_button);
 }
 
 void make_quit_button(scene_t *scene, vector_t point1, vector_t point2, rgb_color_t quit_button_color)
@@ -492,13 +532,14 @@ void make_quit_button(scene_t *scene, vector_t point1, vector_t point2, rgb_colo
     TTF_Font *font = create_font("fonts/adventure.ttf", BUTTON_FONT_SIZE);
 
     list_t *quit_button_shape = polygon_make_rectangle(point1.x, point1.y, point2.x, point2.y);
-    global_body_info_t *quit_button_global_info = create_global_body_info(NULL, QUIT_BUTTON_TYPE);
+    global_body_info_t *quit_button_global_info = create_global_body_info(NULL);
     body_t *quit_button = body_init_with_info_with_label(quit_button_shape, BUTTON_MASS,
                                                          quit_button_color, quit_button_global_info, NULL,
                                                          "QUIT GAME", CTD_FONT_COLOR, font,
                                                          (vector_t){point2.x - point1.x, point2.y - point1.y});
+    body_set_type(quit_button, QUIT_BUTTON_TYPE);
 
-    scene_add_body(scene, quit_button);
+    scene_add_static_body(scene, quit_button);
 }
 
 int get_high_score(char *filename)
@@ -546,7 +587,7 @@ void make_simple_img_body(scene_t *scene, vector_t position, vector_t img_size,
 void welcome_screen(game_state_t *game_state)
 {
     scene_t *scene = game_state->scene;
-    *game_state = initial_game_state(scene);
+    *game_state = initial_game_state(scene, game_state->waves);
     scene_clear(scene);
     game_state->screen = WELCOME_SCREEN;
 
@@ -572,14 +613,15 @@ void welcome_screen(game_state_t *game_state)
     vector_t bottom_corner = (vector_t){650, 50};
     vector_t top_corner = (vector_t){350, 150};
     list_t *begin_game_btn_shape = polygon_make_rectangle(bottom_corner.x, bottom_corner.y, top_corner.x, top_corner.y);
-    global_body_info_t *begin_btn_global_info = create_global_body_info(NULL, BEGIN_BUTTON_TYPE);
+    global_body_info_t *begin_btn_global_info = create_global_body_info(NULL);
     TTF_Font *begin_font = create_font("fonts/MontereyFLF.ttf", BUTTON_FONT_SIZE);
     vector_t begin_btn_text_size = (vector_t){300, 100};
     rgb_color_t begin_game_btn_color = (rgb_color_t){(float)0.53, (float)0.92, (float)0.8};
     body_t *begin_game_btn = body_init_with_info_with_label(begin_game_btn_shape, BUTTON_MASS, begin_game_btn_color,
                                                             begin_btn_global_info, NULL, "Click here to begin!",
                                                             CTD_FONT_COLOR, begin_font, begin_btn_text_size);
-    scene_add_body(scene, begin_game_btn);
+    body_set_type(begin_game_btn, BEGIN_BUTTON_TYPE);
+    scene_add_static_body(scene, begin_game_btn);
 }
 
 // HAPPENDS 2ND
@@ -590,7 +632,7 @@ void story_screen(game_state_t *game_state)
     // when button to play is clicked, start screen is called
 
     scene_t *scene = game_state->scene;
-    *game_state = initial_game_state(scene);
+    *game_state = initial_game_state(scene, game_state->waves);
     scene_clear(scene);
     game_state->screen = STORY_SCREEN;
 
@@ -655,14 +697,15 @@ void story_screen(game_state_t *game_state)
     // continue to main menu button
     TTF_Font *adventure_font = create_font("fonts/adventure.ttf", BUTTON_FONT_SIZE);
     list_t *continue_button_shape = polygon_make_rectangle(500, 60, 700, 110);
-    global_body_info_t *continue_button_global_info = create_global_body_info(NULL, MENU_BUTTON_TYPE);
+    global_body_info_t *continue_button_global_info = create_global_body_info(NULL);
     body_t *continue_button = body_init_with_info_with_label(continue_button_shape, BUTTON_MASS,
                                                              (rgb_color_t){(float)1.0, (float)0.44, (float)0.32},
                                                              continue_button_global_info, NULL,
                                                              "CONTINUE", CTD_FONT_COLOR, adventure_font,
                                                              (vector_t){RESTART_BUTTON2.x - RESTART_BUTTON1.x,
                                                                         RESTART_BUTTON2.y - RESTART_BUTTON1.y});
-    scene_add_body(scene, continue_button);
+    body_set_type(continue_button, MENU_BUTTON_TYPE);
+    scene_add_static_body(scene, continue_button);
 
     // quit button
     make_quit_button(scene, (vector_t){750, 60}, (vector_t){950, 110}, (rgb_color_t){(float)1.0, (float)0.44, (float)0.32});
@@ -672,7 +715,7 @@ void story_screen(game_state_t *game_state)
 void start_screen(game_state_t *game_state)
 {
     scene_t *scene = game_state->scene;
-    *game_state = initial_game_state(scene);
+    *game_state = initial_game_state(scene, game_state->waves);
     scene_clear(scene);
     game_state->screen = START_GAME_SCREEN;
 
@@ -692,34 +735,37 @@ void start_screen(game_state_t *game_state)
     vector_t path_text_size = (vector_t){PATH_BUTTON2.x - PATH_BUTTON1.x, PATH_BUTTON2.y - PATH_BUTTON1.y};
     list_t *easy_button_shape = polygon_make_rectangle(bottom_corner.x, bottom_corner.y,
                                                        top_corner.x, top_corner.y);
-    global_body_info_t *easy_path_button_global_info = create_global_body_info(NULL, EASY_PATH_BUTTON_TYPE);
+    global_body_info_t *easy_path_button_global_info = create_global_body_info(NULL);
     TTF_Font *paths_font = create_font("fonts/MontereyFLF.ttf", BUTTON_FONT_SIZE);
     body_t *easy_button = body_init_with_info_with_label(easy_button_shape, BUTTON_MASS,
                                                          PATH_BUTTON_COLOR, easy_path_button_global_info, NULL,
                                                          "EASY PATH", CTD_FONT_COLOR, paths_font, path_text_size);
-    scene_add_body(scene, easy_button);
+    body_set_type(easy_button, EASY_PATH_BUTTON_TYPE);
+    scene_add_static_body(scene, easy_button);
 
     // create medium path
     bottom_corner.x += PATH_BUTTON_WIDTH + PATH_BUTTON_SPACING;
     top_corner.x += PATH_BUTTON_WIDTH + PATH_BUTTON_SPACING;
     list_t *medium_button_shape = polygon_make_rectangle(bottom_corner.x - 10, bottom_corner.y,
                                                          top_corner.x + 10, top_corner.y);
-    global_body_info_t *med_path_button_global_info = create_global_body_info(NULL, MEDIUM_PATH_BUTTON_TYPE);
+    global_body_info_t *med_path_button_global_info = create_global_body_info(NULL);
     body_t *medium_button = body_init_with_info_with_label(medium_button_shape, BUTTON_MASS,
                                                            PATH_BUTTON_COLOR, med_path_button_global_info, NULL,
                                                            "MEDIUM PATH", CTD_FONT_COLOR, paths_font, path_text_size);
-    scene_add_body(scene, medium_button);
+    body_set_type(medium_button, MEDIUM_PATH_BUTTON_TYPE);
+    scene_add_static_body(scene, medium_button);
 
     // create hard path
     bottom_corner.x += PATH_BUTTON_WIDTH + PATH_BUTTON_SPACING;
     top_corner.x += PATH_BUTTON_WIDTH + PATH_BUTTON_SPACING;
     list_t *hard_button_shape = polygon_make_rectangle(bottom_corner.x, bottom_corner.y,
                                                        top_corner.x, top_corner.y);
-    global_body_info_t *hard_path_button_global_info = create_global_body_info(NULL, HARD_PATH_BUTTON_TYPE);
+    global_body_info_t *hard_path_button_global_info = create_global_body_info(NULL);
     body_t *hard_button = body_init_with_info_with_label(hard_button_shape, BUTTON_MASS,
                                                          PATH_BUTTON_COLOR, hard_path_button_global_info, NULL,
                                                          "HARD PATH", CTD_FONT_COLOR, paths_font, path_text_size);
-    scene_add_body(scene, hard_button);
+    body_set_type(hard_button, HARD_PATH_BUTTON_TYPE);
+    scene_add_static_body(scene, hard_button);
 }
 
 void start_game(game_state_t *game_state, draw_path_func_t draw_path)
@@ -730,7 +776,7 @@ void start_game(game_state_t *game_state, draw_path_func_t draw_path)
     setup_tower_configs();
     play_game_screen(game_state);
     create_shop(scene);
-    draw_path(scene, DEMO_WINDOW_HEIGHT);
+    game_state->path = draw_path(scene, DEMO_WINDOW_HEIGHT);
     build_game_walls(game_state);
 }
 
@@ -741,6 +787,7 @@ void game_over_screen(game_state_t *game_state)
 
     scene_t *scene = game_state->scene;
     scene_clear(scene);
+    game_state->path = NULL; // freed with the path body, the viruses here float freely
 
     build_walls(game_state, DEMO_WINDOW_HEIGHT, DEMO_WINDOW_WIDTH);
 
@@ -762,13 +809,10 @@ void game_over_screen(game_state_t *game_state)
             body_t *confetti = body_init(shape, 10, color_rainbow(rand() % 50));
             body_set_velocity(confetti, velocity);
             scene_add_body(game_state->scene, confetti);
-            for (size_t j = 0; j < scene_bodies(game_state->scene); j++)
+            list_t *walls = scene_get_bodies_of_type(game_state->scene, WALL_TYPE);
+            for (size_t j = 0; j < list_size(walls); j++)
             {
-                body_t *curr_body = scene_get_body(game_state->scene, j);
-                if (get_global_type(curr_body) == WALL_TYPE)
-                {
-                    create_physics_collision(game_state->scene, CONFETTI_ELASTICITY, confetti, curr_body);
-                }
+                create_physics_collision(game_state->scene, CONFETTI_ELASTICITY, confetti, list_get(walls, j));
             }
         }
     }
@@ -810,13 +854,14 @@ void game_over_screen(game_state_t *game_state)
                                                           RESTART_BUTTON1.y,
                                                           RESTART_BUTTON2.x - GAMEOVER_SCREEN_RESTART_BTN_OFFSET,
                                                           RESTART_BUTTON2.y);
-    global_body_info_t *info = create_global_body_info(NULL, RESTART_BUTTON_TYPE);
+    global_body_info_t *info = create_global_body_info(NULL);
     TTF_Font *adventure_font = create_font("fonts/adventure.ttf", BUTTON_FONT_SIZE);
     body_t *restart_button = body_init_with_info_with_label(restart_button_shape, BUTTON_MASS, PATH_BUTTON_COLOR,
                                                             info, NULL, "RESTART", CTD_FONT_COLOR, adventure_font,
                                                             (vector_t){RESTART_BUTTON2.x - RESTART_BUTTON1.x,
                                                                        RESTART_BUTTON2.y - RESTART_BUTTON1.y});
-    scene_add_body(scene, restart_button);
+    body_set_type(restart_button, RESTART_BUTTON_TYPE);
+    scene_add_static_body(scene, restart_button);
 
     // quit button
     vector_t point1 = (vector_t){RESTART_BUTTON1.x + GAMEOVER_SCREEN_QUIT_BTN_OFFSET, RESTART_BUTTON1.y};
@@ -824,75 +869,223 @@ void game_over_screen(game_state_t *game_state)
     make_quit_button(scene, point1, point2, PATH_BUTTON_COLOR);
 }
 
+void tick_playing_screen(game_state_t *game_state)
+{
+    scene_t *scene = game_state->scene;
+    tower_index_viruses(scene);
+    list_t *viruses = scene_get_bodies_of_type(scene, VIRUS_TYPE);
+    for (size_t i = 0; i < list_size(viruses); i++)
+    {
+        virus_tick(list_get(viruses, i), game_state->path, SIM_STEP);
+    }
+    list_t *towers = scene_get_bodies_of_type(scene, TOWER_TYPE);
+    for (size_t i = 0; i < list_size(towers); i++)
+    {
+        tower_tick(list_get(towers, i), scene, game_state);
+    }
+    // after the towers, so new bullets are ticked right away
+    list_t *bullets = scene_get_bodies_of_type(scene, BULLET_TYPE);
+    for (size_t i = 0; i < list_size(bullets); i++)
+    {
+        bullet_tick(list_get(bullets, i));
+    }
+    list_t *player_infos = scene_get_bodies_of_type(scene, PLAYER_INFO_TYPE);
+    for (size_t i = 0; i < list_size(player_infos); i++)
+    {
+        char player_txt[MAX_PLAYER_INFO_LENGTH];
+        update_player_info_text(game_state, player_txt);
+        body_set_label(list_get(player_infos, i), player_txt);
+    }
+    // after the viruses are ticked, since a new virus starts where the others have moved to
+    wave_tick(scene, game_state, SIM_STEP);
+    game_state->virus_count = (int)(list_size(viruses) + game_state->spawner.remaining);
+}
+
+#ifdef CTD_PROFILE
+list_t *add_profile_overlay(void)
+{
+    size_t num_lines = sizeof(OVERLAY_ZONES) / sizeof(OVERLAY_ZONES[0]);
+    TTF_Font *font = create_font("fonts/futura.ttf", OVERLAY_FONT_SIZE);
+    // kept out of the scene, so changing screens doesn't free them
+    list_t *lines = list_init(num_lines, (free_func_t)text_free);
+    for (size_t i = 0; i < num_lines; i++)
+    {
+        vector_t position = {.x = OVERLAY_POSITION.x, .y = OVERLAY_POSITION.y - i * OVERLAY_LINE_SIZE.y};
+        text_t *line = text_init("", position, OVERLAY_LINE_SIZE, CTD_FONT_COLOR, font);
+        list_add(lines, line);
+    }
+    sdl_set_overlay(lines);
+    return lines;
+}
+
+void update_profile_overlay(list_t *lines)
+{
+    if (profile_frames() % OVERLAY_UPDATE_FRAMES != 0)
+    {
+        return;
+    }
+    char buffer[MAX_PLAYER_INFO_LENGTH];
+    for (size_t i = 0; i < list_size(lines); i++)
+    {
+        profile_format_zone(OVERLAY_ZONES[i], buffer, sizeof(buffer));
+        text_set(list_get(lines, i), buffer);
+    }
+}
+#endif
+
+#ifdef CTD_HEADLESS
+void headless_place_tower(game_state_t *game_state, tower_id_t id, vector_t position)
+{
+    // same selection purchase_item() makes when the tower is clicked in the shop
+    int price = tower_get_from_id(id).price;
+    if (price > game_state->money)
+    {
+        printf("not enough money for scripted tower %d \n", id);
+        return;
+    }
+    game_state->last_clicked_item_type = SHOP_TYPE;
+    game_state->global_shop_item_selected = TOWER_TYPE;
+    game_state->specific_shop_item_selected = id;
+    game_state->purchased_item_cost = price;
+    shop_place_item(game_state, position, DEMO_PLAYING_WIDTH, DEMO_PLAYING_HEIGHT);
+}
+
 int main(int argc, char *argv[])
 {
     srand(42);
 
+    sdl_init_headless(VEC_ZERO, (vector_t){.x = DEMO_WINDOW_WIDTH, .y = DEMO_WINDOW_HEIGHT}, SIM_STEP);
+
+    scene_t *scene = scene_init();
+    game_state_t *game_state = malloc(sizeof(game_state_t));
+    assert(game_state != NULL);
+    *game_state = initial_game_state(scene, load_waves());
+    virus_add_collision_rules(scene, game_state);
+    bullet_add_collision_rules(scene, game_state);
+    start_game(game_state, draw_simple_path);
+
+    size_t num_towers = sizeof(HEADLESS_TOWERS) / sizeof(HEADLESS_TOWERS[0]);
+    size_t next_tower = 0;
+    double total_ms = 0.0;
+    size_t total_ticks = 0;
+    while (game_state->level < MAX_LEVEL && game_state->health > 0)
+    {
+        while (next_tower < num_towers && HEADLESS_TOWERS[next_tower].wave <= game_state->level)
+        {
+            headless_place_tower(game_state, HEADLESS_TOWERS[next_tower].id, HEADLESS_TOWERS[next_tower].position);
+            next_tower++;
+        }
+
+        int wave = game_state->level;
+        clock_t start = clock();
+        game_state->money += load_wave(game_state->level++, scene, game_state);
+        size_t ticks = 0;
+        do
+        {
+            // one step per call, since headless time advances by exactly SIM_STEP
+            for (size_t step = sdl_fixed_steps(SIM_STEP, MAX_CATCH_UP_STEPS); step > 0; step--)
+            {
+                tick_playing_screen(game_state);
+                scene_tick(scene, SIM_STEP);
+                ticks++;
+#ifdef CTD_PROFILE
+                profile_frame();
+#endif
+            }
+        } while (game_state->virus_count > 0 && game_state->health > 0 && ticks < HEADLESS_MAX_WAVE_TICKS);
+        double ms = (double)(clock() - start) * HEADLESS_MS_PER_S / CLOCKS_PER_SEC;
+
+        printf("wave %2d: %6zu ticks %9.3f ms %7.3f us/tick  health %d  money %d\n",
+               wave, ticks, ms, ms * HEADLESS_MS_PER_S / ticks, game_state->health, game_state->money);
+        total_ms += ms;
+        total_ticks += ticks;
+    }
+    printf("%s after %d waves: %zu ticks in %.3f ms\n", game_state->health > 0 ? "won" : "lost",
+           game_state->level, total_ticks, total_ms);
+#ifdef CTD_PROFILE
+    if (profile_write_trace(PROFILE_TRACE_PATH))
+    {
+        printf("profile of the last ticks written to %s\n", PROFILE_TRACE_PATH);
+    }
+#endif
+
+    wave_table_free(game_state->waves);
+    scene_free(scene);
+    free(game_state);
+    sdl_cleanup();
+    return 0;
+}
+#else
+int main(int argc, char *argv[])
+{
+    if (argc > 1 && strcmp(argv[1], WRITE_WAVES_FLAG) == 0)
+    {
+        return write_precompiled_waves() ? 0 : 1;
+    }
+    srand(42);
+
     sdl_init(VEC_ZERO, (vector_t){.x = DEMO_WINDOW_WIDTH, .y = DEMO_WINDOW_HEIGHT});
     sdl_on_mouse((mouse_handler_t)covid_mouse_handler);
     sdl_on_key((key_handler_t)covid_key_handler);
+    sdl_preload_fonts(PRELOAD_FONT_PATHS, PRELOAD_FONT_SIZES,
+                      sizeof(PRELOAD_FONT_SIZES) / sizeof(PRELOAD_FONT_SIZES[0]));
 
     sound_t *background_music = sound_init("sounds/quietcreepybackgroundmusic.wav", NUM_LOOPS);
     sound_play(background_music);
 
     scene_t *scene = scene_init();
     game_state_t *game_state = malloc(sizeof(game_state_t));
-    *game_state = initial_game_state(scene);
+    *game_state = initial_game_state(scene, load_waves());
+    virus_add_collision_rules(scene, game_state);
+    bullet_add_collision_rules(scene, game_state);
     welcome_screen(game_state); // game starts with welcome, then story, then start_screen
+#ifdef CTD_PROFILE
+    list_t *profile_overlay = add_profile_overlay();
+#endif
 
     while (!sdl_is_done(game_state))
     {
-        if (game_state->screen == PLAYING_SCREEN)
+        // GAME SCENE INTERVAL
+        size_t steps = sdl_fixed_steps(SIM_STEP, MAX_CATCH_UP_STEPS);
+        for (size_t step = 0; step < steps; step++)
         {
-            // update
-            int virus_count = 0;
-            for (size_t i = 0; i < scene_bodies(scene); i++)
+            if (game_state->screen == PLAYING_SCREEN)
             {
-                body_t *curr_body = scene_get_body(scene, i);
-                if (get_global_type(curr_body) == VIRUS_TYPE)
-                {
-                    virus_count++;
-                    virus_tick(curr_body);
-                }
-                else if (get_global_type(curr_body) == BULLET_TYPE)
-                {
-                    bullet_tick(curr_body);
-                }
-                else if (get_global_type(curr_body) == PLAYER_INFO_TYPE)
+                tick_playing_screen(game_state);
+
+                if (game_state->level >= MAX_LEVEL && game_state->virus_count == 0)
                 {
-                    char *player_txt = body_get_label(curr_body)->txt;
-                    update_player_info_text(game_state, player_txt);
+                    update_score_txt("scores.txt", game_state->score);
+                    game_state->screen = WIN_SCREEN;
+                    sound_play(game_state->win_sound);
+                    game_over_screen(game_state);
                 }
-                else if (get_global_type(curr_body) == TOWER_TYPE)
+                else if (game_state->health <= 0)
                 {
-                    tower_tick(curr_body, scene, game_state);
+                    update_score_txt("scores.txt", game_state->score);
+                    game_state->screen = LOSE_SCREEN;
+                    sound_play(game_state->lose_sound);
+                    game_over_screen(game_state);
                 }
             }
-            game_state->virus_count = virus_count;
-
-            if (game_state->level >= MAX_LEVEL && virus_count == 0)
-            {
-                update_score_txt("scores.txt", game_state->score);
-                game_state->screen = WIN_SCREEN;
-                sound_play(game_state->win_sound);
-                game_over_screen(game_state);
-            }
-            else if (game_state->health <= 0)
-            {
-                update_score_txt("scores.txt", game_state->score);
-                game_state->screen = LOSE_SCREEN;
-                sound_play(game_state->lose_sound);
-                game_over_screen(game_state);
-            }
+            scene_tick(game_state->scene, SIM_STEP);
         }
-
-        // GAME SCENE INTERVAL
-        double dt = time_since_last_tick();
-        scene_tick(game_state->scene, dt);
-        sdl_render_scene(game_state->scene);
+        sdl_render_scene_interpolated(game_state->scene, sdl_step_alpha());
+#ifdef CTD_PROFILE
+        profile_frame();
+        update_profile_overlay(profile_overlay);
+#endif
     }
 
     // CLEANUP
+#ifdef CTD_PROFILE
+    profile_write_trace(PROFILE_TRACE_PATH);
+    sdl_set_overlay(NULL);
+    list_free(profile_overlay);
+#endif
+    wave_table_free(game_state->waves);
     scene_free(scene);
+    sdl_cleanup();
     return 1;
 }
+#endif
@@ -0,0 +1,95 @@
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <stdbool.h>
+
+/**
+ * A bump allocator for temporaries, e.g. the axes of a collision test or the
+ * pixel coordinates of a polygon being drawn.
+ * Allocating is O(1) and nothing is freed individually: everything allocated
+ * after a mark is released at once by rewinding to the mark.
+ * Memory is allocated in chunks which are kept for reuse, so once the arena has
+ * grown to fit a frame it never calls malloc() again.
+ */
+typedef struct arena arena_t;
+
+/**
+ * A position in an arena to rewind to.
+ */
+typedef struct arena_mark
+{
+    size_t chunk;
+    size_t offset;
+} arena_mark_t;
+
+/**
+ * Allocates memory for an empty arena.
+ * Asserts that the chunk size is positive.
+ *
+ * @param chunk_size the number of bytes to allocate at a time
+ * @return the new arena
+ */
+arena_t *arena_init(size_t chunk_size);
+
+/**
+ * Releases the memory allocated for an arena, including everything allocated from it.
+ *
+ * @param arena a pointer to an arena returned from arena_init()
+ */
+void arena_free(arena_t *arena);
+
+/**
+ * Allocates memory from an arena, aligned like memory returned by malloc().
+ * The memory stays valid until the arena is rewound to a mark taken before this call.
+ *
+ * @param arena a pointer to an arena returned from arena_init()
+ * @param size the number of bytes to allocate
+ * @return a pointer to the memory
+ */
+void *arena_alloc(arena_t *arena, size_t size);
+
+/**
+ * Returns the current position of an arena.
+ *
+ * @param arena a pointer to an arena returned from arena_init()
+ * @return the mark to pass to arena_rewind()
+ */
+arena_mark_t arena_mark(arena_t *arena);
+
+/**
+ * Releases everything allocated from an arena since a mark was taken.
+ *
+ * @param arena a pointer to an arena returned from arena_init()
+ * @param mark a mark returned from arena_mark() on the same arena
+ */
+void arena_rewind(arena_t *arena, arena_mark_t mark);
+
+/**
+ * Releases everything allocated from an arena.
+ *
+ * @param arena a pointer to an arena returned from arena_init()
+ */
+void arena_reset(arena_t *arena);
+
+/**
+ * Returns the number of bytes an arena has allocated from the system.
+ *
+ * @param arena a pointer to an arena returned from arena_init()
+ * @return size_t
+ */
+size_t arena_capacity(arena_t *arena);
+
+/**
+ * Returns the engine's arena for per-frame temporaries.
+ * scene_tick() and sdl_render_scene() rewind it to where it was when they started,
+ * so anything allocated from it during a tick or render lasts until that ends.
+ * Code outside of them should take a mark and rewind to it when done.
+ *
+ * @return the frame arena
+ */
+arena_t *frame_arena(void);
+
+#endif // #ifndef __ARENA_H__
@@ -5,6 +5,7 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "color.h"
 #include "text.h"
@@ -21,6 +22,43 @@
  */
 typedef struct body body_t;
 
+/**
+ * Storage for the kinematic state (centroid, velocity, forces, impulses and mass)
+ * of many bodies in parallel arrays, so they can all be integrated in one pass.
+ * Bodies in a store keep working through the usual body_t functions.
+ */
+typedef struct body_store body_store_t;
+
+/**
+ * A reference to a body that is safe to keep across ticks.
+ * Every body has a slot in a slot map for as long as it is allocated.
+ * When the body is freed, the slot's generation changes, so old handles to it
+ * resolve to NULL instead of to whichever body reuses the slot.
+ */
+typedef struct body_handle
+{
+    uint32_t index;
+    uint32_t generation;
+} body_handle_t;
+
+/**
+ * A handle that never refers to a body.
+ */
+extern const body_handle_t BODY_HANDLE_NONE;
+
+/**
+ * What a body's polygon is, so collisions can use a closed-form test.
+ * Regular polygons, e.g. from polygon_make_circle(), are treated as circles
+ * through their vertices, and axis-aligned rectangles as boxes.
+ * Everything else, e.g. stars, is a general polygon.
+ */
+typedef enum shape_kind
+{
+    SHAPE_POLYGON,
+    SHAPE_CIRCLE,
+    SHAPE_AABB
+} shape_kind_t;
+
 /**
  * Initializes a body without any info.
  * Acts like body_init_with_info() where info and info_freer are NULL.
@@ -65,7 +103,8 @@ body_t *body_init_with_info_with_label(list_t *shape, double mass, rgb_color_t b
  * The body is initially at rest.
  * Asserts that the mass is positive and that the required memory is allocated.
  *
- * @param shape a list of vectors describing the initial shape of the body
+ * @param shape a list of vectors describing the initial shape of the body.
+ *   The vertices are copied into the body and the list is freed.
  * @param mass the mass of the body (if INFINITY, stops the body from moving)
  * @param color the color of the body, used to draw it on the screen
  * @param info additional information to associate with the body,
@@ -75,14 +114,53 @@ body_t *body_init_with_info_with_label(list_t *shape, double mass, rgb_color_t b
  */
 body_t *body_init_with_info(list_t *shape, double mass, rgb_color_t color, void *info, free_func_t info_freer);
 
+/**
+ * Like body_init_with_info(), but the body uses the shape in place instead of copying it,
+ * so nothing is allocated besides the body itself.
+ * The body moves and rotates the shape's vertices but never frees them,
+ * so they can live in memory the info owns, e.g. a pooled info block.
+ *
+ * @param shape the initial shape of the body, which must stay valid until the body is freed
+ * @param mass the mass of the body (if INFINITY, stops the body from moving)
+ * @param color the color of the body, used to draw it on the screen
+ * @param info additional information to associate with the body
+ * @param info_freer if non-NULL, a function call on the info to free it
+ * @return a pointer to the newly allocated body
+ */
+body_t *body_init_with_shape(polygon_t *shape, double mass, rgb_color_t color, void *info, free_func_t info_freer);
+
 /**
  * Releases the memory allocated for a body. Does NOT free the image or label.
  * Use image_free(body_get_image(body)) and text_free(body_get_label(body)).
+ * Handles to the body resolve to NULL afterwards.
  *
  * @param body a pointer to a body returned from body_init()
  */
 void body_free(body_t *body);
 
+/**
+ * Returns a handle to a body, which stays valid until the body is freed.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the body's handle
+ */
+body_handle_t body_get_handle(body_t *body);
+
+/**
+ * Looks up the body a handle refers to in O(1).
+ *
+ * @param handle a handle returned from body_get_handle(), or BODY_HANDLE_NONE
+ * @return the body, or NULL if it has been freed
+ */
+body_t *body_from_handle(body_handle_t handle);
+
+/**
+ * Returns the number of bodies that have been initialized and not yet freed.
+ *
+ * @return size_t
+ */
+size_t body_count(void);
+
 /**
  * Gets the size of a body.
  *
@@ -91,6 +169,32 @@ void body_free(body_t *body);
  */
 double body_get_size(body_t *body);
 
+/**
+ * Gets what kind of shape a body has.
+ * This is worked out from the vertices when the body is initialized or rotated.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return SHAPE_CIRCLE, SHAPE_AABB or SHAPE_POLYGON
+ */
+shape_kind_t body_get_shape_kind(body_t *body);
+
+/**
+ * Gets the radius of a body whose shape is a SHAPE_CIRCLE,
+ * i.e. the distance from its centroid to its vertices.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the radius of the circle
+ */
+double body_get_radius(body_t *body);
+
+/**
+ * Gets the half width and half height of a body whose shape is a SHAPE_AABB.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the distance from the centroid to the box's edges along x and y
+ */
+vector_t body_get_half_extents(body_t *body);
+
 /**
  * Gets the current shape of a body.
  * Returns a newly allocated vector list, which must be list_free()d.
@@ -100,6 +204,17 @@ double body_get_size(body_t *body);
  */
 list_t *body_get_shape(body_t *body);
 
+/**
+ * Gets a read-only view of the current vertices of a body without copying them.
+ * The array is owned by the body and is only valid until the body is
+ * moved, rotated or freed.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param num_points set to the number of vertices in the array
+ * @return the vertices of the body's current polygon, in order
+ */
+const vector_t *body_peek_shape(body_t *body, size_t *num_points);
+
 /**
  * Gets the current center of mass of a body.
  * While this could be calculated with polygon_centroid(), that becomes too slow
@@ -111,6 +226,17 @@ list_t *body_get_shape(body_t *body);
  */
 vector_t body_get_centroid(body_t *body);
 
+/**
+ * Gets a position between the body's centroid before its last tick and its
+ * current centroid, used to draw smooth motion between fixed simulation steps.
+ * Setting the centroid directly moves the body without interpolation.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param alpha 0 for the centroid before the last tick, 1 for the current one
+ * @return the interpolated centroid
+ */
+vector_t body_get_interpolated_centroid(body_t *body, double alpha);
+
 /**
  * Gets the current velocity of a body.
  *
@@ -160,6 +286,24 @@ void *body_get_info(body_t *body);
  */
 void body_set_info(body_t *body, void *info);
 
+/**
+ * Gets the type of a body, which scenes group their bodies by.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the type passed to body_set_type(), or 0 if it was never set
+ */
+int body_get_type(body_t *body);
+
+/**
+ * Sets the type of a body, e.g. a global_body_type_t.
+ * Scenes look the type up when the body is added,
+ * so it must be set before adding the body to a scene.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param type a non-negative type
+ */
+void body_set_type(body_t *body, int type);
+
 /**
  * Translates a body to a new position.
  * The position is specified by the position of the body's center of mass.
@@ -281,4 +425,45 @@ text_t *body_get_label(body_t *body);
  */
 void body_set_label(body_t *body, char *label);
 
+/**
+ * Allocates memory for an empty body store.
+ *
+ * @return the new store
+ */
+body_store_t *body_store_init(void);
+
+/**
+ * Releases the memory allocated for a body store.
+ * The bodies in it are not freed; they keep their state and leave the store.
+ *
+ * @param store a pointer to a store returned from body_store_init()
+ */
+void body_store_free(body_store_t *store);
+
+/**
+ * Moves the kinematic state of a body into a store.
+ * Asserts that the body is not already in a store.
+ *
+ * @param store a pointer to a store returned from body_store_init()
+ * @param body a pointer to a body returned from body_init()
+ */
+void body_store_add(body_store_t *store, body_t *body);
+
+/**
+ * Moves the kinematic state of a body back out of a store.
+ * body_free() does this automatically.
+ *
+ * @param store the store the body was added to
+ * @param body a pointer to a body in the store
+ */
+void body_store_remove(body_store_t *store, body_t *body);
+
+/**
+ * Ticks every body in a store, like calling body_tick() on each of them.
+ *
+ * @param store a pointer to a store returned from body_store_init()
+ * @param dt the number of seconds elapsed since the last tick
+ */
+void body_store_tick(body_store_t *store, double dt);
+
 #endif // #ifndef __BODY_H__
@@ -22,6 +22,7 @@ typedef struct bullet_t
     double glue_slowdown;
     int num_tack_directions;
     double alive_ticks;
+    collision_handler_t virus_handler; // called when the bullet hits a virus, NULL if harmless
 } bullet_t;
 
 /**
@@ -35,6 +36,17 @@ typedef struct bullet_t
 body_t *create_basic_bullet(scene_t *scene, vector_t position, rgb_color_t color, bullet_t info);
 
 body_t *create_explosion_effect_bullet(scene_t *scene, vector_t position);
+
+/**
+ * @brief Registers the collision rules for bullets with the scene:
+ * bullets hitting viruses call their virus_handler and bullets hitting walls are removed.
+ * Only needs to be called once per scene.
+ *
+ * @param scene scene where bullets will be displayed
+ * @param game_state game state passed to each bullet's virus_handler
+ */
+void bullet_add_collision_rules(scene_t *scene, game_state_t *game_state);
+
 /**
  * @brief deletes bullets after their alive_ticks
  * 
@@ -0,0 +1,79 @@
+#ifndef __BVH_H__
+#define __BVH_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <stdbool.h>
+
+#include "body.h"
+#include "list.h"
+#include "vector.h"
+
+/**
+ * A bounding volume hierarchy over bodies that don't move, e.g. walls,
+ * buttons and placed towers.
+ * Each body is bounded by the axis-aligned box around its vertices, and the
+ * boxes are split in half along their longer side at every level of the tree,
+ * so a query only visits the O(log n) nodes near the queried area.
+ *
+ * The tree is built once with bvh_build() and must be rebuilt if any of the
+ * bodies move. Its storage is kept between builds.
+ */
+typedef struct bvh bvh_t;
+
+/**
+ * Allocates memory for an empty tree.
+ *
+ * @return the new tree
+ */
+bvh_t *bvh_init(void);
+
+/**
+ * Releases the memory allocated for a tree. Does not free the bodies in it.
+ *
+ * @param bvh a pointer to a tree returned from bvh_init()
+ */
+void bvh_free(bvh_t *bvh);
+
+/**
+ * Replaces the contents of a tree with the given bodies at their current positions.
+ *
+ * @param bvh a pointer to a tree returned from bvh_init()
+ * @param bodies a list of body_t pointers
+ */
+void bvh_build(bvh_t *bvh, list_t *bodies);
+
+/**
+ * Updates the box of one body that moved since the tree was built, and the boxes above it.
+ * The body is found through its handle, and nothing is sorted or allocated,
+ * so this only costs the depth of the tree. The tree isn't rebalanced, so rebuild it
+ * instead if bodies move far from where they were built.
+ *
+ * @param bvh a pointer to a tree built with bvh_build()
+ * @param body the body that moved
+ * @return whether the body was in the tree
+ */
+bool bvh_refit(bvh_t *bvh, body_t *body);
+
+/**
+ * Finds the bodies whose bounding boxes are within a distance of a point.
+ * Pass a radius of 0 to find the bodies whose boxes contain the point.
+ * The boxes are only bounds, so callers should test the actual shapes of the results.
+ *
+ * @param bvh a pointer to a tree built with bvh_build()
+ * @param center the point to search around
+ * @param radius the distance to search within
+ * @param results a list that the body_t pointers found are added to
+ */
+void bvh_query_circle(bvh_t *bvh, vector_t center, double radius, list_t *results);
+
+/**
+ * Gets the number of bodies in a tree.
+ *
+ * @param bvh a pointer to a tree returned from bvh_init()
+ * @return the number of bodies passed to the last bvh_build()
+ */
+size_t bvh_bodies(bvh_t *bvh);
+
+#endif // #ifndef __BVH_H__
@@ -4,6 +4,8 @@
 #include <stdbool.h>
 #include "list.h"
 #include "vector.h"
+#include "polygon.h"
+#include "body.h"
 
 /**
  * Represents the status of a collision between two shapes.
@@ -22,6 +24,16 @@ typedef struct
     vector_t axis;
 } collision_info_t;
 
+/**
+ * A function called when a collision occurs.
+ * @param body1 the first body passed to create_collision()
+ * @param body2 the second body passed to create_collision()
+ * @param axis a unit vector pointing from body1 towards body2
+ *   that defines the direction the two bodies are colliding in
+ * @param aux the auxiliary value passed to create_collision()
+ */
+typedef void (*collision_handler_t)(body_t *body1, body_t *body2, vector_t axis, void *aux);
+
 /**
  * Computes the status of the collision between two convex polygons.
  * The shapes are given as lists of vertices in counterclockwise order.
@@ -35,4 +47,89 @@ typedef struct
  */
 collision_info_t find_collision(list_t *shape1, list_t *shape2);
 
+/**
+ * Computes the status of the collision between two convex polygons
+ * given as contiguous vertex arrays, e.g. from body_peek_shape().
+ * Behaves like find_collision() without copying the vertices.
+ *
+ * @param shape1 the vertices of the first shape
+ * @param size1 the number of vertices in shape1
+ * @param shape2 the vertices of the second shape
+ * @param size2 the number of vertices in shape2
+ * @return whether the shapes are colliding, and if so, the collision axis.
+ */
+collision_info_t find_collision_points(const vector_t *shape1, size_t size1,
+                                       const vector_t *shape2, size_t size2);
+
+/**
+ * Behaves exactly like find_collision_points(), but projects one vertex at a time.
+ * find_collision_points() projects with AVX2 when compiled with "make AVX2=1",
+ * otherwise with SSE2 where the target has it; this is the reference for both.
+ *
+ * @param shape1 the vertices of the first shape
+ * @param size1 the number of vertices in shape1
+ * @param shape2 the vertices of the second shape
+ * @param size2 the number of vertices in shape2
+ * @return whether the shapes are colliding, and if so, the collision axis.
+ */
+collision_info_t find_collision_points_scalar(const vector_t *shape1, size_t size1,
+                                              const vector_t *shape2, size_t size2);
+
+/**
+ * Computes the status of the collision between two packed convex polygons.
+ *
+ * @param shape1 the first shape
+ * @param shape2 the second shape
+ * @return whether the shapes are colliding, and if so, the collision axis.
+ */
+collision_info_t find_polygon_collision(const polygon_t *shape1, const polygon_t *shape2);
+
+/**
+ * Computes the status of the collision between two circles.
+ * Circles that are just touching count as colliding, like in find_collision().
+ *
+ * @param center1 the center of the first circle
+ * @param radius1 the radius of the first circle
+ * @param center2 the center of the second circle
+ * @param radius2 the radius of the second circle
+ * @return whether the circles are colliding, and if so, the collision axis.
+ */
+collision_info_t find_circle_collision(vector_t center1, double radius1, vector_t center2, double radius2);
+
+/**
+ * Computes the status of the collision between a circle and an axis-aligned box.
+ *
+ * @param center the center of the circle
+ * @param radius the radius of the circle
+ * @param box_center the center of the box
+ * @param half_extents the half width and half height of the box
+ * @return whether the shapes are colliding, and if so, the collision axis,
+ * pointing from the circle towards the box.
+ */
+collision_info_t find_circle_aabb_collision(vector_t center, double radius,
+                                            vector_t box_center, vector_t half_extents);
+
+/**
+ * Computes the status of the collision between two axis-aligned boxes.
+ *
+ * @param center1 the center of the first box
+ * @param half_extents1 the half width and half height of the first box
+ * @param center2 the center of the second box
+ * @param half_extents2 the half width and half height of the second box
+ * @return whether the boxes are colliding, and if so, the collision axis.
+ */
+collision_info_t find_aabb_collision(vector_t center1, vector_t half_extents1,
+                                     vector_t center2, vector_t half_extents2);
+
+/**
+ * Computes the status of the collision between the current shapes of two bodies.
+ * Circles and axis-aligned boxes (see body_get_shape_kind()) are tested in closed form;
+ * any other polygon goes through find_collision_points().
+ *
+ * @param body1 the first body
+ * @param body2 the second body
+ * @return whether the bodies are colliding, and if so, the collision axis.
+ */
+collision_info_t find_body_collision(body_t *body1, body_t *body2);
+
 #endif // #ifndef __COLLISION_H__
@@ -4,16 +4,6 @@
 #include "scene.h"
 #include "collision.h"
 
-/**
- * A function called when a collision occurs.
- * @param body1 the first body passed to create_collision()
- * @param body2 the second body passed to create_collision()
- * @param axis a unit vector pointing from body1 towards body2
- *   that defines the direction the two bodies are colliding in
- * @param aux the auxiliary value passed to create_collision()
- */
-typedef void (*collision_handler_t)(body_t *body1, body_t *body2, vector_t axis, void *aux);
-
 /**
  * Adds a force creator to a scene that applies gravity between two bodies.
  * The force creator will be called each tick
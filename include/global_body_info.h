@@ -15,7 +15,6 @@ typedef enum
     PATH_TYPE,
     BULLET_TYPE,
     NEXT_WAVE_BUTTON_TYPE,
-    PATH_TURN_NODE_TYPE,
     WALL_TYPE,
     TOOL_TYPE,
     MOUSE_TYPE,
@@ -31,9 +30,9 @@ typedef enum
     QUIT_BUTTON_TYPE
 } global_body_type_t;
 
+// the body's type is kept in the body itself, see body_get_type()
 typedef struct global_body_info
 {
-    global_body_type_t type;
     void *secondary_info;
 } global_body_info_t;
 
@@ -48,6 +47,17 @@ typedef enum
     LOSE_SCREEN
 } game_screen_t;
 
+#define WAVE_SPEED_BOOSTS 10 // a virus's speed boost is a single digit
+
+// the viruses of the current wave still to be spawned, see wave_tick()
+typedef struct wave_spawner
+{
+    int wave;                       // the wave being spawned
+    double time;                    // seconds since the wave was loaded
+    size_t remaining;               // viruses of the wave not spawned yet
+    size_t next[WAVE_SPEED_BOOSTS]; // for each speed boost, the index of the next virus with it to spawn
+} wave_spawner_t;
+
 typedef struct game_state
 {
     scene_t *scene;
@@ -56,7 +66,10 @@ typedef struct game_state
     int level;
     int score;
     global_body_type_t last_clicked_item_type; // set to nothing if background is clicked
-    body_t *last_tower_selected;
+    body_handle_t last_tower_selected; // BODY_HANDLE_NONE if no tower is selected
+    body_handle_t shop_item_preview;   // body following the mouse while placing an item, if any
+    struct path *path;                 // center line of the path being played, NULL off the playing screen
+    struct wave_table *waves;          // every wave of the game, loaded once at startup
     int global_shop_item_selected;   // temporary item or tower
     int specific_shop_item_selected; // type of temporary item OR type of tower
     int purchased_item_cost;
@@ -67,14 +80,15 @@ typedef struct game_state
     sound_t *lose_sound;
     text_t *shop_description; // NULL if no description being displayed
     image_t *help_image;
-    int virus_count;
+    int virus_count;        // viruses in the scene plus those still to be spawned
+    wave_spawner_t spawner; // zeroed when there is nothing left to spawn
 } game_state_t;
 
 /**
- * @brief Get the global body type of a body
+ * @brief Get the global body type of a body, which is stored in the body itself
  *
  * @param body to get body type of
- * @return body type of the selected body
+ * @return body type of the selected body, NOTHING if it was never given one
  */
 global_body_type_t get_global_type(body_t *body);
 
@@ -87,17 +101,18 @@ global_body_type_t get_global_type(body_t *body);
 void *get_global_secondary_info(body_t *body);
 
 /**
- * @brief Create a global_body_info_t
+ * @brief Create a global_body_info_t. The body it is given to also needs
+ * body_set_type() with its global body type, unless it was made by body_init_with_secondary_info().
  *
  * @param secondary_info a void* that can hold extra info such as a specific struct
  * associated with the global body type (eg. a tower_t for a tower body)
- * @param global_body_type the type of body
  * @return global_body_info_t*
  */
-global_body_info_t *create_global_body_info(void *secondary_info, global_body_type_t global_body_type);
+global_body_info_t *create_global_body_info(void *secondary_info);
 
 /**
- * @brief creates a body with a global type and info
+ * @brief creates a body with a global type and info.
+ * Bodies given a global info some other way need body_set_type() too.
  *
  * @param shape
  * @param mass
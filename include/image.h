@@ -14,6 +14,8 @@ typedef struct image
     vector_t size;
     bool removed;
     int image_type; // IMG_INIT_PNG or IMG_INIT_JPG
+    struct texture *texture; // shared decoded image, see sdl_texture_acquire()
+    struct body *owner;      // body the image moves with, drawn where that body is drawn; NULL if none
 } image_t;
 
 /**
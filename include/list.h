@@ -5,6 +5,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <stdbool.h>
 
 /**
  * A growable array of pointers.
@@ -19,6 +20,12 @@ typedef struct list list_t;
  */
 typedef void (*free_func_t)(void *);
 
+/**
+ * A function that decides whether a list element should be removed.
+ * Examples: body_is_removed
+ */
+typedef bool (*list_predicate_t)(void *);
+
 /**
  * Allocates memory for a new list with space for the given number of elements.
  * The list is initially empty.
@@ -76,6 +83,17 @@ void *list_get(list_t *list, size_t index);
  */
 void *list_remove(list_t *list, size_t index);
 
+/**
+ * Removes every element of a list that matches a predicate, in a single pass.
+ * The remaining elements keep their order.
+ * Removed elements are released with the list's freer, if it has one.
+ *
+ * @param list a pointer to a list returned from list_init()
+ * @param should_remove returns true for the elements to remove
+ * @return the number of elements removed
+ */
+size_t list_remove_if(list_t *list, list_predicate_t should_remove);
+
 /**
  * Appends an element to the end of a list.
  * If the list is filled to capacity, resizes the list to fit more elements
@@ -16,44 +16,86 @@
 #include "vector.h"
 #include "scene.h"
 #include "collision.h"
-#include "virus.h"
 #include "global_body_info.h"
 
 /**
- * @brief path struct, stores info about the path
+ * @brief The center line of a path, compiled into a polyline with the arc length
+ * from the start to each of its points, so a virus only has to know how far along
+ * the path it is. Looking up a position is a binary search over the segments.
+ * Before the start and past the end, the path continues in a straight line
+ * from its first and last segments.
+ */
+typedef struct path path_t;
+
+/**
+ * @brief draw_simple_path, draw_medium_path, draw_complex_path
+ *
+ */
+typedef path_t *(*draw_path_func_t)(scene_t *scene, double demo_window_height);
+
+/**
+ * @brief Compiles a polyline into a path. Repeated points are skipped.
+ * Asserts that there are at least two distinct points.
+ *
+ * @param points: the points of the polyline, from start to end
+ * @param num_points: the number of points
+ * @returns the new path
+ */
+path_t *path_init(const vector_t *points, size_t num_points);
+
+/**
+ * @brief Releases the memory allocated for a path
  *
+ * @param path: a path returned from path_init()
  */
+void path_free(path_t *path);
 
-enum TURN_DIRECTION_INT
-{
-    LEFT_TURN,
-    RIGHT_TURN,
-    NO_TURN
-} TURN_DIRECTION_INT;
+/**
+ * @brief Gets the length of a path from its start to its end
+ *
+ * @param path: the path
+ * @returns the arc length of the path
+ */
+double path_get_length(path_t *path);
 
-typedef struct turn_direction
-{
-    int dir;
-    int num; // first (0), second (1), third (2)...
-} turn_direction_t;
+/**
+ * @brief Gets the point a distance along a path
+ *
+ * @param path: the path
+ * @param progress: distance from the start of the path, negative before the start
+ * @returns the point on the path
+ */
+vector_t path_get_position(path_t *path, double progress);
 
-extern const double NODE_RADIUS;
+/**
+ * @brief Gets the direction of a path a distance along it.
+ * At a corner, this is the direction of the segment after the corner.
+ *
+ * @param path: the path
+ * @param progress: distance from the start of the path, negative before the start
+ * @returns unit vector pointing towards the end of the path
+ */
+vector_t path_get_direction(path_t *path, double progress);
 
 /**
- * @brief draw_simple_path, draw_medium_path, draw_complex_path
+ * @brief Finds how far along a path the point on it closest to a position is
  *
+ * @param path: the path
+ * @param position: the position to find on the path
+ * @returns distance from the start of the path, negative before the start
  */
-typedef void (*draw_path_func_t)(scene_t *scene, double demo_window_height);
+double path_get_progress(path_t *path, vector_t position);
 
 /**
- * @brief Creates a path for virus particles to follow and adds it to the scene
+ * @brief Creates a path for virus particles to follow and adds it to the scene.
+ * The path body owns the compiled center line, which runs through the middle of
+ * each pair of outer and inner vertices.
  *
  * @param scene: pointer to the game scene
- * @param vertices: vertices of path
- * @param directions: path turn directions
+ * @param vertices: vertices of path, the outer edge from start to end then the inner edge back
  * @returns body of path created
  */
-body_t *create_path(scene_t *scene, list_t *vertices, list_t *directions);
+body_t *create_path(scene_t *scene, list_t *vertices);
 
 /**
  * @brief Creates a path so intricate it has a mind of its own.
@@ -67,23 +109,26 @@ body_t *create_path_with_a_mind_of_its_own(scene_t *scene);
  *
  * @param scene: game scene
  * @param demo_window_height: game window height
+ * @returns the center line of the path, owned by the path body
  */
-void draw_simple_path(scene_t *scene, double demo_window_height);
+path_t *draw_simple_path(scene_t *scene, double demo_window_height);
 
 /**
  * @brief Draw a medium complexity path on scene
  *
  * @param scene: game scene
  * @param demo_window_height: game window height
+ * @returns the center line of the path, owned by the path body
  */
-void draw_medium_path(scene_t *scene, double demo_window_height);
+path_t *draw_medium_path(scene_t *scene, double demo_window_height);
 
 /**
  * @brief Draw a most complex path on scene
  *
  * @param scene: game scene
  * @param demo_window_height: game window height
+ * @returns the center line of the path, owned by the path body
  */
-void draw_complex_path(scene_t *scene, double demo_window_height);
+path_t *draw_complex_path(scene_t *scene, double demo_window_height);
 
 #endif // #ifndef __PATH_H__
@@ -8,6 +8,106 @@
 #include "list.h"
 #include "vector.h"
 
+/**
+ * A polygon whose vertices are stored contiguously, listed in a
+ * counterclockwise direction. There is an edge between each pair of
+ * consecutive vertices, plus one between the first and last.
+ *
+ * The list_t based functions below are kept for compatibility and
+ * convert to this representation internally.
+ */
+typedef struct polygon
+{
+    vector_t *points;
+    size_t size;
+} polygon_t;
+
+/**
+ * Allocates memory for a polygon with a copy of the given vertices.
+ *
+ * @param points the vertices of the polygon
+ * @param size the number of vertices
+ * @return the new polygon
+ */
+polygon_t *polygon_init(const vector_t *points, size_t size);
+
+/**
+ * Allocates memory for a polygon with the vertices in a list.
+ * Does not free the list.
+ *
+ * @param polygon the list of vertices that make up the polygon
+ * @return the new polygon
+ */
+polygon_t *polygon_from_list(list_t *polygon);
+
+/**
+ * Copies the vertices of a polygon into a newly allocated vector list,
+ * which must be list_free()d.
+ *
+ * @param polygon a polygon returned from polygon_init()
+ * @return the list of vertices
+ */
+list_t *polygon_to_list(const polygon_t *polygon);
+
+/**
+ * Releases the memory allocated for a polygon.
+ *
+ * @param polygon a polygon returned from polygon_init()
+ */
+void polygon_free(polygon_t *polygon);
+
+/**
+ * Computes the area of a packed polygon. See polygon_area().
+ *
+ * @param polygon a polygon returned from polygon_init()
+ * @return the area of the polygon
+ */
+double polygon_packed_area(const polygon_t *polygon);
+
+/**
+ * Computes the center of mass of a packed polygon. See polygon_centroid().
+ *
+ * @param polygon a polygon returned from polygon_init()
+ * @return the centroid of the polygon
+ */
+vector_t polygon_packed_centroid(const polygon_t *polygon);
+
+/**
+ * Translates all vertices in a packed polygon by a given vector.
+ * Note: mutates the original polygon.
+ *
+ * @param polygon a polygon returned from polygon_init()
+ * @param translation the vector to add to each vertex's position
+ */
+void polygon_packed_translate(polygon_t *polygon, vector_t translation);
+
+/**
+ * Rotates vertices in a packed polygon by a given angle about a given point.
+ * Note: mutates the original polygon.
+ *
+ * @param polygon a polygon returned from polygon_init()
+ * @param angle the angle to rotate the polygon, in radians.
+ * A positive angle means counterclockwise.
+ * @param point the point to rotate around
+ */
+void polygon_packed_rotate(polygon_t *polygon, double angle, vector_t point);
+
+/**
+ * Calculates the longest distance from the centroid to a vertex of a packed polygon.
+ *
+ * @param polygon a polygon returned from polygon_init()
+ * @return longest distance from the centroid to a vertex of the polygon
+ */
+double polygon_packed_max_distance_across(const polygon_t *polygon);
+
+/**
+ * Calculates the shortest distance from the centroid to a vertex of a packed polygon.
+ *
+ * @param polygon a polygon returned from polygon_init()
+ * @return shortest distance from the centroid to a vertex of the polygon
+ */
+double polygon_packed_min_distance_across(const polygon_t *polygon);
+
 /**
  * Computes the area of a polygon.
  * See https://en.wikipedia.org/wiki/Shoelace_formula#Statement.
@@ -75,6 +175,17 @@ double polygon_min_distance_across(list_t *shape);
  */
 list_t *polygon_make_circle(vector_t position, double radius, size_t num_points);
 
+/**
+ * @brief Writes the vertices of a circle into an array, without allocating.
+ * Gives the same vertices as polygon_make_circle() when that makes num_points of them.
+ *
+ * @param points array of at least num_points vertices to fill
+ * @param position center of circle
+ * @param radius circle radius
+ * @param num_points number of vertices
+ */
+void polygon_fill_circle(vector_t *points, vector_t position, double radius, size_t num_points);
+
 /**
  * @brief Makes a rectangle shape list of vertices.
  * (x1, y1) lower left corner.
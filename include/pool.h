@@ -0,0 +1,71 @@
+#ifndef __POOL_H__
+#define __POOL_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <stdbool.h>
+
+/**
+ * A pool of fixed-size objects, for things that are created and destroyed
+ * many times a second (bodies, bullets, viruses).
+ * Objects are carved out of large blocks and released objects are reused
+ * first, so allocating and releasing are both O(1) and never call malloc()
+ * once the pool has grown to fit the game.
+ *
+ * Objects never move, and their memory is only returned to the system by pool_free().
+ * When the last object in use is released (e.g. after scene_clear()), the pool
+ * rewinds, so the next objects are handed out in address order from the first block again.
+ */
+typedef struct pool pool_t;
+
+/**
+ * Allocates memory for an empty pool.
+ * Asserts that the object size and block size are positive.
+ *
+ * @param object_size the size of each object, e.g. sizeof(bullet_t)
+ * @param objects_per_block the number of objects to allocate at once when the pool is full
+ * @return the new pool
+ */
+pool_t *pool_init(size_t object_size, size_t objects_per_block);
+
+/**
+ * Releases all the memory allocated for a pool, including objects still in use.
+ *
+ * @param pool a pointer to a pool returned from pool_init()
+ */
+void pool_free(pool_t *pool);
+
+/**
+ * Takes an object out of a pool. The object's contents are undefined.
+ *
+ * @param pool a pointer to a pool returned from pool_init()
+ * @return a pointer to the object
+ */
+void *pool_alloc(pool_t *pool);
+
+/**
+ * Gives an object back to the pool it came from.
+ * Has the signature of a free_func_t, so it can be used as a body's info freer.
+ *
+ * @param object a pointer returned from pool_alloc(), or NULL
+ */
+void pool_release(void *object);
+
+/**
+ * Returns the number of objects taken out of a pool and not yet released.
+ *
+ * @param pool a pointer to a pool returned from pool_init()
+ * @return size_t
+ */
+size_t pool_live(pool_t *pool);
+
+/**
+ * Returns the number of objects a pool can hold without allocating another block.
+ *
+ * @param pool a pointer to a pool returned from pool_init()
+ * @return size_t
+ */
+size_t pool_capacity(pool_t *pool);
+
+#endif // #ifndef __POOL_H__
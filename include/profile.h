@@ -0,0 +1,158 @@
+#ifndef __PROFILE_H__
+#define __PROFILE_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <stdbool.h>
+
+/**
+ * Per-frame profiling of the engine's hot paths.
+ *
+ * Code is instrumented with the PROFILE_BEGIN(), PROFILE_END() and
+ * PROFILE_COUNT() macros, which compile to nothing unless CTD_PROFILE is
+ * defined (build with "make PROFILE=1"). profile_frame() closes the current
+ * frame, so each frame's zone times and counters can be read back, drawn on
+ * screen or written out as a Chrome trace (chrome://tracing or Perfetto).
+ *
+ * The last PROFILE_MAX_FRAMES frames and PROFILE_MAX_EVENTS zone events are
+ * kept in ring buffers; older ones are overwritten.
+ * A zone must not be entered again before it has ended.
+ */
+
+/**
+ * The instrumented regions of code.
+ */
+typedef enum profile_zone
+{
+    PROFILE_SCENE_TICK,
+    PROFILE_SCENE_FORCES,
+    PROFILE_SCENE_COLLISION_RULES,
+    PROFILE_SCENE_INTEGRATE,
+    PROFILE_SCENE_REMOVE,
+    PROFILE_COLLISION_CREATOR,
+    PROFILE_FIND_COLLISION,
+    PROFILE_TOWER_TICK,
+    PROFILE_RENDER,
+    PROFILE_RENDER_POLYGONS,
+    PROFILE_RENDER_TEXT,
+    PROFILE_RENDER_IMAGES,
+    PROFILE_ASSET_LOAD,
+    NUM_PROFILE_ZONES
+} profile_zone_t;
+
+/**
+ * Quantities summed over each frame.
+ */
+typedef enum profile_counter
+{
+    PROFILE_BODIES,
+    PROFILE_COLLISION_TESTS,
+    PROFILE_DRAW_CALLS,
+    PROFILE_TEXTS_RASTERIZED,
+    NUM_PROFILE_COUNTERS
+} profile_counter_t;
+
+#ifdef CTD_PROFILE
+#define PROFILE_BEGIN(zone) profile_begin(zone)
+#define PROFILE_END(zone) profile_end(zone)
+#define PROFILE_COUNT(counter, amount) profile_count(counter, amount)
+#else
+#define PROFILE_BEGIN(zone) ((void)0)
+#define PROFILE_END(zone) ((void)0)
+#define PROFILE_COUNT(counter, amount) ((void)0)
+#endif
+
+/**
+ * @brief Starts timing a zone. Use PROFILE_BEGIN() instead in instrumented code.
+ *
+ * @param zone the zone being entered
+ */
+void profile_begin(profile_zone_t zone);
+
+/**
+ * @brief Stops timing a zone, adding the time since profile_begin() to the
+ * current frame and recording an event for the trace.
+ * Use PROFILE_END() instead in instrumented code.
+ *
+ * @param zone the zone being left
+ */
+void profile_end(profile_zone_t zone);
+
+/**
+ * @brief Adds to a counter of the current frame. Use PROFILE_COUNT() instead in instrumented code.
+ *
+ * @param counter the counter to add to
+ * @param amount the amount to add
+ */
+void profile_count(profile_counter_t counter, size_t amount);
+
+/**
+ * @brief Ends the current frame and starts the next one.
+ */
+void profile_frame(void);
+
+/**
+ * @brief Returns the number of frames ended since the program started.
+ *
+ * @return size_t
+ */
+size_t profile_frames(void);
+
+/**
+ * @brief Returns the time spent in a zone during the last ended frame.
+ *
+ * @param zone the zone
+ * @return double the time in milliseconds
+ */
+double profile_last_ms(profile_zone_t zone);
+
+/**
+ * @brief Returns the number of times a zone was entered during the last ended frame.
+ *
+ * @param zone the zone
+ * @return size_t
+ */
+size_t profile_last_calls(profile_zone_t zone);
+
+/**
+ * @brief Returns the value of a counter for the last ended frame.
+ *
+ * @param counter the counter
+ * @return size_t
+ */
+size_t profile_last_count(profile_counter_t counter);
+
+/**
+ * @brief Returns the name a zone is shown with in traces and overlays.
+ *
+ * @param zone the zone
+ * @return const char*
+ */
+const char *profile_zone_name(profile_zone_t zone);
+
+/**
+ * @brief Writes a one line summary of a zone in the last ended frame,
+ * e.g. "render 1.25 ms (1)", for drawing in a text_t.
+ *
+ * @param zone the zone
+ * @param buffer where to write the summary
+ * @param size the size of buffer
+ */
+void profile_format_zone(profile_zone_t zone, char *buffer, size_t size);
+
+/**
+ * @brief Writes the retained frames to a file in the Chrome trace event format:
+ * one complete event per zone entry and one counter event per frame.
+ *
+ * @param filename the file to write
+ * @return true if the file was written
+ */
+bool profile_write_trace(const char *filename);
+
+/**
+ * @brief Discards all recorded frames and events.
+ */
+void profile_reset(void);
+
+#endif // #ifndef __PROFILE_H__
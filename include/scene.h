@@ -10,6 +10,7 @@
 #include "body.h"
 #include "list.h"
 #include "text.h"
+#include "collision.h"
 // #include "global_body_info.h"
 
 /**
@@ -69,6 +70,17 @@ list_t *scene_get_bodies(scene_t *scene);
  */
 body_t *scene_get_body(scene_t *scene, size_t index);
 
+/**
+ * Gets the bodies of a type in a scene, in the order they were added,
+ * without looking at the bodies of other types.
+ * Bodies stay in the list until they are freed, like in scene_get_bodies().
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param type a body_get_type() value
+ * @return the bodies of the type, owned by the scene
+ */
+list_t *scene_get_bodies_of_type(scene_t *scene, int type);
+
 /**
  * Adds a body to a scene.
  *
@@ -77,6 +89,49 @@ body_t *scene_get_body(scene_t *scene, size_t index);
  */
 void scene_add_body(scene_t *scene, body_t *body);
 
+/**
+ * Adds a body that never moves to a scene, e.g. a wall, a button or a placed tower.
+ * Static bodies are indexed for scene_query_static(), and otherwise behave like
+ * bodies added with scene_add_body().
+ * If a static body does get moved, call scene_static_body_moved().
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param body a pointer to the body to add to the scene
+ */
+void scene_add_static_body(scene_t *scene, body_t *body);
+
+/**
+ * Tells a scene that some of its static bodies moved,
+ * so it re-indexes them before the next scene_query_static().
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ */
+void scene_static_bodies_moved(scene_t *scene);
+
+/**
+ * Tells a scene that one of its static bodies moved a little, e.g. an airplane tower
+ * flying around its circle. Only the body's box is updated, without re-indexing
+ * the other static bodies, so this is cheap enough to call every tick.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param body a static body in the scene
+ */
+void scene_static_body_moved(scene_t *scene, body_t *body);
+
+/**
+ * Finds the static bodies that may be within a distance of a point,
+ * in O(log n) time for n static bodies.
+ * A body is found if its bounding box is within the distance,
+ * so callers should check the body's actual shape.
+ * Bodies that have been removed are never found.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param center the point to search around, e.g. the mouse position
+ * @param radius the distance to search within, 0 to find the bodies over the point
+ * @param results a list that the body_t pointers found are added to
+ */
+void scene_query_static(scene_t *scene, vector_t center, double radius, list_t *results);
+
 /**
  * @deprecated Use body_remove() instead
  *
@@ -120,9 +175,33 @@ void scene_add_bodies_force_creator(
     list_t *bodies,
     free_func_t freer);
 
+/**
+ * Registers a collision handler for every pair of bodies of two types.
+ * Each tick, the bodies of the types with rules are sorted into a spatial grid
+ * by body_get_size() and only pairs sharing a grid cell are checked with find_collision().
+ * Like create_collision(), the handler is only called on the tick
+ * two bodies start colliding, not while they stay in contact.
+ * Rules are kept by scene_clear(). Registering the same handler for the same
+ * types again does nothing, and frees the new aux with freer.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param type1 the body_get_type() of the first body passed to handler
+ * @param type2 the body_get_type() of the second body passed to handler
+ * @param handler a function to call whenever the bodies collide
+ * @param aux an auxiliary value to pass to the handler
+ * @param freer if non-NULL, a function to call in order to free aux
+ */
+void scene_add_collision_rule(
+    scene_t *scene,
+    int type1,
+    int type2,
+    collision_handler_t handler,
+    void *aux,
+    free_func_t freer);
+
 /**
  * Executes a tick of a given scene over a small time interval.
- * This requires executing all the force creators
+ * This requires executing all the force creators and collision rules
  * and then ticking each body (see body_tick()).
  * If any bodies are marked for removal, they should be removed from the scene
  * and freed, along with any force creators acting on them.
@@ -205,7 +284,7 @@ void scene_add_image(scene_t *scene, image_t *image);
 void scene_remove_image(scene_t *scene, size_t i);
 
 /**
- * @brief Frees SDL stuff
+ * @brief Frees SDL stuff, including every cached texture
  * 
  */
 void sdl_cleanup();
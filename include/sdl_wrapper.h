@@ -76,6 +76,20 @@ typedef void (*mouse_handler_t)(mouse_event_type_t type, vector_t mouse_pos, voi
  */
 void sdl_init(vector_t min, vector_t max);
 
+/**
+ * Initializes the SDL wrapper without a window, renderer or audio device,
+ * e.g. to run the simulation on a machine without a display.
+ * Drawing functions do nothing, sdl_is_done() always returns false,
+ * create_font() returns NULL and time_since_last_tick() always returns dt,
+ * so sdl_fixed_steps() with a step of dt always returns one step.
+ * Use instead of sdl_init(); sdl_cleanup() must still be called at the end.
+ *
+ * @param min the x and y coordinates of the bottom left of the scene
+ * @param max the x and y coordinates of the top right of the scene
+ * @param dt the fixed number of seconds each tick advances the simulation
+ */
+void sdl_init_headless(vector_t min, vector_t max, double dt);
+
 /**
  * Processes all SDL events and returns whether the window has been closed.
  * This function must be called in order to handle keypresses.
@@ -98,6 +112,40 @@ void sdl_clear(void);
  */
 void sdl_draw_polygon(list_t *points, rgb_color_t color);
 
+/**
+ * Draws a polygon from a contiguous array of vertices and a color,
+ * e.g. the vertices returned by body_peek_shape().
+ *
+ * @param points the vertices of the polygon
+ * @param num_points the number of vertices
+ * @param color the color used to fill in the polygon
+ */
+void sdl_draw_points(const vector_t *points, size_t num_points, rgb_color_t color);
+
+/**
+ * A decoded image shared by every image_t with the same filename and type.
+ * Each image file is only loaded from disk once, the first time it is drawn,
+ * and is freed when the last image using it is freed.
+ */
+typedef struct texture texture_t;
+
+/**
+ * Gets the shared texture for an image file, adding a reference to it.
+ * Does not load the file until the texture is first drawn.
+ *
+ * @param image_filename the path of the image file
+ * @param image_type IMG_INIT_PNG or IMG_INIT_JPG
+ * @return the shared texture, to be released with sdl_texture_release()
+ */
+texture_t *sdl_texture_acquire(const char *image_filename, int image_type);
+
+/**
+ * Removes a reference to a shared texture, freeing it if it was the last one.
+ *
+ * @param texture a texture returned from sdl_texture_acquire(), or NULL
+ */
+void sdl_texture_release(texture_t *texture);
+
 /**
  * Displays the rendered frame on the SDL window.
  * Must be called after drawing the polygons in order to show them.
@@ -106,13 +154,36 @@ void sdl_show(void);
 
 /**
  * Draws all bodies in a scene.
- * This internally calls sdl_clear(), sdl_draw_polygon(), and sdl_show(),
+ * Convex bodies are queued as triangle fans and submitted together with
+ * SDL_RenderGeometry(), so the number of draw calls doesn't grow with the
+ * number of bodies; concave bodies fall back to sdl_draw_points().
+ * This internally calls sdl_clear() and sdl_show(),
  * so those functions should not be called directly.
  *
  * @param scene the scene to draw
  */
 void sdl_render_scene(scene_t *scene);
 
+/**
+ * Draws all bodies in a scene like sdl_render_scene(), but with each body
+ * partway between where it was before the last scene tick and where it is now.
+ * Images and text labels are drawn at their current positions.
+ *
+ * @param scene the scene to draw
+ * @param alpha the fraction of the last tick to show, usually sdl_step_alpha()
+ */
+void sdl_render_scene_interpolated(scene_t *scene, double alpha);
+
+/**
+ * Sets texts to draw on top of every scene rendered from now on, e.g. debug output.
+ * They stay on screen across scene_clear(), since they aren't part of any scene.
+ * The list and texts are not freed by the renderer; call sdl_set_overlay(NULL)
+ * before freeing them.
+ *
+ * @param texts a list of text_t pointers, or NULL for no overlay
+ */
+void sdl_set_overlay(list_t *texts);
+
 /**
  * Registers a function to be called every time a key is pressed.
  * Overwrites any existing handler.
@@ -157,6 +228,27 @@ void sdl_on_mouse(mouse_handler_t handler);
  */
 double time_since_last_tick(void);
 
+/**
+ * Adds the wall time since the last call to a fixed-step accumulator and
+ * returns how many steps of the given length the simulation should take.
+ * Ticking the scene by exactly step seconds that many times keeps gameplay
+ * independent of the frame rate. If the simulation falls more than max_steps
+ * behind, the extra time is dropped rather than caught up on later.
+ *
+ * @param step the length of one simulation step, in seconds
+ * @param max_steps the most steps to return for a single frame
+ * @return the number of steps to simulate this frame
+ */
+size_t sdl_fixed_steps(double step, size_t max_steps);
+
+/**
+ * Gets how far the current frame is between the last two simulation steps,
+ * as computed by the last call to sdl_fixed_steps().
+ *
+ * @return a fraction from 0 to 1, to pass to sdl_render_scene_interpolated()
+ */
+double sdl_step_alpha(void);
+
 /**
  * @brief pauses the SLD window for number_of_seconds
  * 
@@ -174,12 +266,24 @@ vector_t get_window_center(void);
 /**
  * @brief Create a font object. If invalid .ttf path,
  * font rendered is Vertigo which is the default font.
+ * Fonts are opened once per path and size and shared between callers,
+ * so the returned font must not be closed; sdl_cleanup() closes them all.
  * 
  * @param font_path font .ttf filename
  * @param font_size 
  * @return TTF_Font* 
  */
 TTF_Font *create_font(const char *font_path, int font_size);
+
+/**
+ * @brief Opens fonts ahead of time so that later create_font() calls
+ * with the same path and size don't touch the disk.
+ *
+ * @param font_paths font .ttf filenames
+ * @param font_sizes point size to open each font at
+ * @param num_fonts number of entries in font_paths and font_sizes
+ */
+void sdl_preload_fonts(const char *const *font_paths, const int *font_sizes, size_t num_fonts);
 //REMEMBER TO USE CREATE FONT AFTER INITIALIZING THE SCENE
 
 #endif // #ifndef __SDL_WRAPPER_H__
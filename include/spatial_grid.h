@@ -0,0 +1,115 @@
+#ifndef __SPATIAL_GRID_H__
+#define __SPATIAL_GRID_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <stdbool.h>
+
+#include "body.h"
+#include "vector.h"
+
+/**
+ * A uniform grid used as a broad phase for collision detection.
+ * Each body is inserted into every cell overlapped by the square of
+ * half-width body_get_size() around its centroid.
+ * Bodies that share no cell cannot be colliding.
+ *
+ * The grid is rebuilt from scratch every tick: spatial_grid_clear(),
+ * spatial_grid_insert() for each body, then spatial_grid_build().
+ * Its storage is kept between ticks, so rebuilding does not allocate
+ * once the grid has grown to fit the scene.
+ */
+typedef struct spatial_grid spatial_grid_t;
+
+/**
+ * A function called for each pair of bodies that share a grid cell.
+ *
+ * @param body1 the body that was inserted first
+ * @param body2 the body that was inserted second
+ * @param aux the auxiliary value passed to spatial_grid_for_each_pair()
+ */
+typedef void (*grid_pair_handler_t)(body_t *body1, body_t *body2, void *aux);
+
+/**
+ * A function called for each body near a point.
+ *
+ * @param body the body
+ * @param index the number of bodies inserted before it since the last spatial_grid_clear()
+ * @param aux the auxiliary value passed to spatial_grid_for_each_near()
+ */
+typedef void (*grid_body_handler_t)(body_t *body, size_t index, void *aux);
+
+/**
+ * Allocates memory for an empty grid.
+ * Asserts that the cell size is positive.
+ *
+ * @param cell_size the side length of each square cell
+ * @return the new grid
+ */
+spatial_grid_t *spatial_grid_init(double cell_size);
+
+/**
+ * Releases the memory allocated for a grid. Does not free the bodies in it.
+ *
+ * @param grid a pointer to a grid returned from spatial_grid_init()
+ */
+void spatial_grid_free(spatial_grid_t *grid);
+
+/**
+ * Removes every body from the grid, keeping its storage for reuse.
+ *
+ * @param grid a pointer to a grid returned from spatial_grid_init()
+ */
+void spatial_grid_clear(spatial_grid_t *grid);
+
+/**
+ * Adds a body to every cell it overlaps.
+ * The grid must be rebuilt with spatial_grid_build() before it is queried.
+ *
+ * @param grid a pointer to a grid returned from spatial_grid_init()
+ * @param body the body to add
+ */
+void spatial_grid_insert(spatial_grid_t *grid, body_t *body);
+
+/**
+ * Sorts the inserted bodies by cell so the grid can be queried.
+ *
+ * @param grid a pointer to a grid returned from spatial_grid_init()
+ */
+void spatial_grid_build(spatial_grid_t *grid);
+
+/**
+ * Calls a handler once for each pair of bodies that share at least one cell.
+ * A pair that shares several cells is only reported once.
+ *
+ * @param grid a pointer to a grid built with spatial_grid_build()
+ * @param handler the function to call with each pair
+ * @param aux an auxiliary value to pass to the handler
+ */
+void spatial_grid_for_each_pair(spatial_grid_t *grid, grid_pair_handler_t handler, void *aux);
+
+/**
+ * Calls a handler once for each body whose bounding square overlaps the square
+ * of half-width radius around a point, and possibly for other bodies in the cells
+ * covering that square. Only those cells are visited, so callers should check
+ * the actual distance to each body.
+ *
+ * @param grid a pointer to a grid built with spatial_grid_build()
+ * @param center the point to search around
+ * @param radius the distance to search within
+ * @param handler the function to call with each body
+ * @param aux an auxiliary value to pass to the handler
+ */
+void spatial_grid_for_each_near(spatial_grid_t *grid, vector_t center, double radius,
+                                grid_body_handler_t handler, void *aux);
+
+/**
+ * Gets the number of bodies inserted since the last spatial_grid_clear().
+ *
+ * @param grid a pointer to a grid returned from spatial_grid_init()
+ * @return the number of bodies in the grid
+ */
+size_t spatial_grid_bodies(spatial_grid_t *grid);
+
+#endif // #ifndef __SPATIAL_GRID_H__
@@ -16,6 +16,9 @@ typedef struct text
     rgb_color_t color;
     TTF_Font *font;
     bool removed;
+    SDL_Texture *texture; // the rasterized text, reused until the text is changed
+    bool dirty;           // whether texture is out of date and must be rasterized again
+    struct body *owner;   // body the text is a label of, drawn where that body is drawn; NULL if none
 } text_t;
 
 /**
@@ -210,6 +210,37 @@ tower_t tower_make_airplane_struct(int price, double range, int upgrade_level, b
  */
 body_t *create_tower(scene_t *scene, tower_t tower_info, vector_t position);
 
+/**
+ * @brief indexes where every virus is, so towers only look at the viruses near them,
+ * and keeps the viruses sorted by how far along the path they are, so the front
+ * virus in range is the one in range that comes first in that order;
+ * should be called every tick before any tower_tick(), since towers target
+ * the viruses found by the last call
+ *
+ * @param scene the scene that the game is in
+ */
+void tower_index_viruses(scene_t *scene);
+
+/**
+ * @brief finds the virus furthest along the path within a distance of a point,
+ * only looking at the grid cells the distance covers
+ *
+ * @param tower_position the point to search around, usually a tower's centroid
+ * @param radius the distance to search within, usually a tower's range
+ * @return the front virus in range as of the last tower_index_viruses(), or NULL if none are in range
+ */
+body_t *tower_get_front_virus(vector_t tower_position, double radius);
+
+/**
+ * @brief damages a virus, giving the player score and money for it, and removes it if it
+ * has no health left; a super virus spawns its smaller viruses where it was on the path
+ *
+ * @param virus_body the virus to damage
+ * @param damage how much health to take away
+ * @param game_state the game state to add score and money to
+ */
+void virus_damage(body_t *virus_body, int damage, game_state_t *game_state);
+
 /**
  * @brief updates a tower
  *
@@ -36,13 +36,14 @@ extern const int SUPER_VIRUS_SPEED_MULTIPLIER;
 typedef struct virus
 {
     int health;
-    double distance_travelled;
+    double progress; // distance along the path
+    double speed;    // along the path, negative if pushed backwards
     bool is_super_virus;
-    int path_nodes; // number of path nodes hit by the virus
 } virus_t;
 
 /**
- * @brief Created COVID virus particle. The color of the virus is dependent on the health value. Add virus to the scene
+ * @brief Created COVID virus particle. The color of the virus is dependent on the health value. Add virus to the scene.
+ * If a path is being played, the virus is put on the closest point of the path, heading along it.
  *
  * @param scene: pointer to the game scene
  * @param health: health of the virus
@@ -54,32 +55,24 @@ typedef struct virus
 body_t *create_virus(scene_t *scene, int health, vector_t speed, vector_t position, game_state_t *game_state, bool is_super_virus);
 
 /**
- * @brief Creates a right turn collision force
+ * @brief Registers the collision rules for viruses with the scene:
+ * leaving through walls, and hitting tools.
+ * Only needs to be called once per scene.
  *
- * @param virus the body that turns right upon hitting the path_node
- * @param path_node
- * @param axis
- * @param scene
+ * @param scene: pointer to the game scene
+ * @param game_state: game state to be updated when viruses go out of bounds
  */
-void virus_path_node_right_collision(body_t *virus, body_t *path_node, vector_t axis, scene_t *scene);
+void virus_add_collision_rules(scene_t *scene, game_state_t *game_state);
 
 /**
- * @brief Creates a left turn collision force
+ * @brief Moves a virus along the path, to be called each tick before the scene is ticked.
+ * Anything pushing on the virus body, like glue, changes its speed along the path.
  *
- * @param virus the body that turns left upon hitting the path_node
- * @param path_node
- * @param axis
- * @param aux
+ * @param virus_body: current virus to update
+ * @param path: the path being played, or NULL if viruses move freely
+ * @param dt: the time until the next tick
  */
-void virus_path_node_left_collision(body_t *virus, body_t *path_node, vector_t axis, void *aux);
-
-/**
- * @brief update virus cumulative distance travelled, to be updated each tick
- *
- * @param virus: current virus to update
- * @param dist: distance travelled since last update
-*/
-void virus_tick(body_t *virus_body);
+void virus_tick(body_t *virus_body, path_t *path, double dt);
 
 //////////////////////////////////////////////////////////////////////////////////////////
 
@@ -93,14 +86,6 @@ void virus_tick(body_t *virus_body);
  */
 double virus_get_radius(virus_t *virus);
 
-/**
- * @brief sets the path_nodes of a virus info
- *
- * @param virus_body
- * @param path_nodes
- */
-void virus_set_path_nodes(body_t *virus_body, int path_nodes);
-
 /**
  * @brief
  *
@@ -118,12 +103,12 @@ int virus_get_health(virus_t *virus);
 rgb_color_t virus_get_color(int health);
 
 /**
- * @brief Gets the distance travelled by the virus on a path
+ * @brief Gets how far along the path a virus is, so the virus with the most progress is at the front
  *
  * @param virus: pointer to the virus invader
- * @return the distance traveled
+ * @return the distance along the path, negative before the start
  */
-double virus_get_distance_travelled(virus_t *virus);
+double virus_get_progress(virus_t *virus);
 
 /**
  * @brief sets health
@@ -133,14 +118,6 @@ double virus_get_distance_travelled(virus_t *virus);
  */
 void virus_set_health(virus_t *virus, int new_health);
 
-/**
- * @brief gets path nodes virus has passed
- *
- * @param virus pointer to virus to get the path nodes of
- * @return virus path nodes
- */
-int virus_get_path_nodes(virus_t *virus);
-
 /**
  * @brief checks whether a virus is a super virus
  *
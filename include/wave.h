@@ -0,0 +1,123 @@
+#ifndef __WAVE_H__
+#define __WAVE_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include <ctype.h>
+#include <string.h>
+
+#include "vector.h"
+#include "scene.h"
+#include "global_body_info.h"
+#include "virus.h"
+
+/**
+ * One virus of a wave, as parsed from a letter of waves.txt.
+ */
+typedef struct wave_virus
+{
+    uint32_t offset;     // how many virus spacings before the start of the path it spawns
+    uint8_t health;      // 'a' = 1 to 'z' = 26, 0 for a super virus
+    uint8_t speed_boost; // the virus moves 1 + speed_boost / 10 times as fast
+    bool is_super_virus;
+} wave_virus_t;
+
+/**
+ * Every wave of a wave file, parsed once so that a wave can be spawned without
+ * reading the file again. The viruses of all the waves are kept in one array,
+ * so finding a wave is O(1).
+ *
+ * A table can be written out with wave_table_write() and memory-mapped back
+ * with wave_table_map(), which skips parsing altogether. "make waves.bin" does
+ * this for waves.txt, and wave_table_load() picks the table up while it is up to date.
+ */
+typedef struct wave_table wave_table_t;
+
+/**
+ * @brief Parses a wave file. Each line is a wave: each letter is a virus with health 'a' = 1 to 'z' = 26,
+ * an optional digit after it speeds the virus up by that many tenths, and '!' is a super virus.
+ * The column of each virus is how far before the start of the path it spawns. Lines can be any length.
+ *
+ * @param filename: path to the wave file, e.g. "waves.txt"
+ * @returns the parsed waves, or NULL if the file can't be opened
+ */
+wave_table_t *wave_table_init(const char *filename);
+
+/**
+ * @brief Maps a table written by wave_table_write() into memory, without copying or parsing it.
+ *
+ * @param filename: path to the precompiled table
+ * @returns the table, or NULL if the file can't be opened or isn't a table for this build
+ */
+wave_table_t *wave_table_map(const char *filename);
+
+/**
+ * @brief Loads a wave file, mapping its precompiled table instead if there is one
+ * that was written after the wave file was last changed.
+ *
+ * @param filename: path to the wave file, e.g. "waves.txt"
+ * @param precompiled_filename: path to the table written from it, e.g. "waves.bin"
+ * @returns the table, or NULL if neither can be loaded
+ */
+wave_table_t *wave_table_load(const char *filename, const char *precompiled_filename);
+
+/**
+ * @brief Writes a table to a file in the format read by wave_table_map().
+ * The format is specific to the machine that wrote it.
+ *
+ * @param table: the table to write
+ * @param filename: path to the file to write
+ * @returns whether the whole table was written
+ */
+bool wave_table_write(wave_table_t *table, const char *filename);
+
+/**
+ * @brief Releases a table, unmapping it if it was mapped.
+ *
+ * @param table: a table returned from wave_table_init() or wave_table_map()
+ */
+void wave_table_free(wave_table_t *table);
+
+/**
+ * @brief Gets the number of waves in a table.
+ *
+ * @param table: the table of waves
+ * @returns the number of lines in the wave file
+ */
+size_t wave_table_size(wave_table_t *table);
+
+/**
+ * @brief Gets the viruses of one wave, in the order they appear on its line.
+ *
+ * @param table: the table of waves
+ * @param n: which wave to get (starting at 0)
+ * @param num_viruses: set to the number of viruses in the wave, 0 past the last wave
+ * @returns the viruses of the wave, valid until the table is freed
+ */
+const wave_virus_t *wave_table_get(wave_table_t *table, size_t n, size_t *num_viruses);
+
+/**
+ * @brief Starts spawning one wave from game_state->waves, replacing any wave still being spawned.
+ * The viruses are lined up before the start of the path, but each is only added to the scene
+ * once it gets close to the start, by this and then wave_tick(), so a long wave doesn't stall a frame.
+ *
+ * @param n: which wave to load (starting at 0)
+ * @param scene: pointer to the game scene
+ * @param game_state: game state to be updated by the viruses, with the waves to load from
+ * @returns the total health of the viruses in the wave, including super virus spawns
+ */
+int load_wave(int n, scene_t *scene, game_state_t *game_state);
+
+/**
+ * @brief Spawns the viruses of the loaded wave that have reached the start of the path,
+ * where they would be if they had been in the scene since the wave was loaded.
+ *
+ * @param scene: pointer to the game scene
+ * @param game_state: game state whose spawner is advanced
+ * @param dt: time since the last call, or since load_wave()
+ */
+void wave_tick(scene_t *scene, game_state_t *game_state, double dt);
+
+#endif // #ifndef __WAVE_H__
@@ -0,0 +1,127 @@
+#include <stddef.h>
+#include "list.h"
+#include "arena.h"
+
+const size_t ARENA_ALIGNMENT = sizeof(max_align_t);
+const size_t FRAME_ARENA_CHUNK_SIZE = 64 * 1024;
+
+typedef struct arena_chunk
+{
+    char *memory;
+    size_t capacity;
+} arena_chunk_t;
+
+typedef struct arena
+{
+    list_t *chunks; // chunks after the current one are empty, kept for reuse
+    size_t chunk_size;
+    size_t chunk;  // index of the chunk being allocated from
+    size_t offset; // bytes used in the current chunk
+} arena_t;
+
+arena_t *engine_frame_arena = NULL;
+
+// PRIVATE HELPER FUNCTION DECLARATIONS
+void arena_chunk_free(arena_chunk_t *chunk);
+arena_chunk_t *arena_chunk_init(size_t capacity);
+
+arena_chunk_t *arena_chunk_init(size_t capacity)
+{
+    arena_chunk_t *chunk = malloc(sizeof(arena_chunk_t));
+    assert(chunk != NULL);
+    chunk->memory = malloc(capacity);
+    assert(chunk->memory != NULL);
+    chunk->capacity = capacity;
+    return chunk;
+}
+
+void arena_chunk_free(arena_chunk_t *chunk)
+{
+    free(chunk->memory);
+    free(chunk);
+}
+
+arena_t *arena_init(size_t chunk_size)
+{
+    assert(chunk_size > 0);
+    arena_t *arena = malloc(sizeof(arena_t));
+    assert(arena != NULL);
+    arena->chunks = list_init(1, (free_func_t)arena_chunk_free);
+    list_add(arena->chunks, arena_chunk_init(chunk_size));
+    arena->chunk_size = chunk_size;
+    arena->chunk = 0;
+    arena->offset = 0;
+    return arena;
+}
+
+void arena_free(arena_t *arena)
+{
+    list_free(arena->chunks);
+    free(arena);
+}
+
+void *arena_alloc(arena_t *arena, size_t size)
+{
+    size_t rounded = (size + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+    arena_chunk_t *chunk = list_get(arena->chunks, arena->chunk);
+    if (arena->offset + rounded > chunk->capacity)
+    {
+        // move on to the next chunk, making sure it is big enough
+        arena->chunk++;
+        arena->offset = 0;
+        size_t capacity = rounded > arena->chunk_size ? rounded : arena->chunk_size;
+        if (arena->chunk == list_size(arena->chunks))
+        {
+            list_add(arena->chunks, arena_chunk_init(capacity));
+        }
+        chunk = list_get(arena->chunks, arena->chunk);
+        if (chunk->capacity < rounded)
+        {
+            // nothing is allocated from this chunk yet, so it can be replaced
+            free(chunk->memory);
+            chunk->memory = malloc(capacity);
+            assert(chunk->memory != NULL);
+            chunk->capacity = capacity;
+        }
+    }
+    void *memory = chunk->memory + arena->offset;
+    arena->offset += rounded;
+    return memory;
+}
+
+arena_mark_t arena_mark(arena_t *arena)
+{
+    return (arena_mark_t){.chunk = arena->chunk, .offset = arena->offset};
+}
+
+void arena_rewind(arena_t *arena, arena_mark_t mark)
+{
+    assert(mark.chunk < arena->chunk || (mark.chunk == arena->chunk && mark.offset <= arena->offset));
+    arena->chunk = mark.chunk;
+    arena->offset = mark.offset;
+}
+
+void arena_reset(arena_t *arena)
+{
+    arena->chunk = 0;
+    arena->offset = 0;
+}
+
+size_t arena_capacity(arena_t *arena)
+{
+    size_t capacity = 0;
+    for (size_t i = 0; i < list_size(arena->chunks); i++)
+    {
+        capacity += ((arena_chunk_t *)list_get(arena->chunks, i))->capacity;
+    }
+    return capacity;
+}
+
+arena_t *frame_arena(void)
+{
+    if (engine_frame_arena == NULL)
+    {
+        engine_frame_arena = arena_init(FRAME_ARENA_CHUNK_SIZE);
+    }
+    return engine_frame_arena;
+}
@@ -1,25 +1,269 @@
 #include "body.h"
+#include "pool.h"
 
 const double SIZE_MULTIPLIER = 0.9;
+const size_t INITIAL_STORE_CAPACITY = 16;
+const size_t INITIAL_SLOT_CAPACITY = 64;
+const size_t BODY_POOL_BLOCK_SIZE = 256;
+const uint32_t NO_FREE_SLOT = UINT32_MAX;
+const size_t MIN_CIRCLE_POINTS = 4;
+const double SHAPE_TOLERANCE = 1e-6; // relative to the size of the shape
+// generation 0 is never handed out, so BODY_HANDLE_NONE never resolves
+const body_handle_t BODY_HANDLE_NONE = {.index = 0, .generation = 0};
 
-typedef struct body
+// kinematic state of a body while it is not in a body store
+typedef struct body_state
 {
-    list_t *shape;
-    double mass;
-    rgb_color_t color;
-    vector_t velocity;
     vector_t centroid;
-    double angle;
+    vector_t previous_centroid;
+    vector_t velocity;
     vector_t forces;
     vector_t impulses;
+    double mass;
+} body_state_t;
+
+typedef struct body
+{
+    polygon_t *shape;
+    bool owns_shape;         // false if the shape was given to body_init_with_shape()
+    vector_t shape_centroid; // centroid the shape vertices were last moved to
+    rgb_color_t color;
+    double angle;
     bool remove_flag;
     void *info;
     free_func_t info_freer;
+    int type; // kept inline, since scenes look it up for every body
     double size;    // stores the max distance across the polygon shape
+    shape_kind_t shape_kind;
+    double radius;          // only for SHAPE_CIRCLE
+    vector_t half_extents;  // only for SHAPE_AABB
     image_t *image; // sprite image that moves with the body, use body_set_image(body, image) after init
     text_t *label;  // a rendered text label, eg. a button called "next wave"
+
+    // hot state, pointing either into own_state or into the arrays of store
+    vector_t *centroid;
+    vector_t *previous_centroid; // centroid before the last tick, for interpolating renders
+    vector_t *velocity;
+    vector_t *forces;
+    vector_t *impulses;
+    double *mass;
+    body_state_t own_state;
+    body_store_t *store;
+    size_t slot;
+    body_handle_t handle;
 } body_t;
 
+typedef struct body_store
+{
+    body_t **bodies;
+    vector_t *centroids;
+    vector_t *previous_centroids;
+    vector_t *velocities;
+    vector_t *forces;
+    vector_t *impulses;
+    double *masses;
+    bool *attached; // whether the body has an image or label to move along with it
+    size_t size;
+    size_t capacity;
+} body_store_t;
+
+typedef struct body_slot
+{
+    body_t *body; // NULL while the slot is free
+    uint32_t generation;
+    uint32_t next_free;
+} body_slot_t;
+
+// every allocated body, so handles can be checked and resolved in O(1)
+typedef struct body_slot_map
+{
+    body_slot_t *slots;
+    size_t size;
+    size_t capacity;
+    uint32_t free_head; // most recently freed slot, reused first
+    size_t live;
+} body_slot_map_t;
+
+body_slot_map_t body_slots = {.slots = NULL, .size = 0, .capacity = 0, .live = 0};
+pool_t *body_pool = NULL;
+
+// PRIVATE HELPER FUNCTION DECLARATIONS
+void body_point_to_own_state(body_t *body);
+void body_point_to_store(body_t *body);
+void body_sync_shape(body_t *body);
+void body_classify_shape(body_t *body);
+bool body_shape_is_aabb(body_t *body, double tolerance);
+bool body_shape_is_regular(body_t *body, double tolerance);
+void body_move_attachments(body_t *body);
+void body_store_resize(body_store_t *store, size_t capacity);
+body_handle_t body_slot_acquire(body_t *body);
+void body_slot_release(body_handle_t handle);
+
+body_handle_t body_slot_acquire(body_t *body)
+{
+    if (body_slots.slots == NULL)
+    {
+        body_slots.slots = malloc(INITIAL_SLOT_CAPACITY * sizeof(body_slot_t));
+        assert(body_slots.slots != NULL);
+        body_slots.capacity = INITIAL_SLOT_CAPACITY;
+        body_slots.free_head = NO_FREE_SLOT;
+    }
+
+    uint32_t index;
+    if (body_slots.free_head != NO_FREE_SLOT)
+    {
+        index = body_slots.free_head;
+        body_slots.free_head = body_slots.slots[index].next_free;
+    }
+    else
+    {
+        if (body_slots.size >= body_slots.capacity)
+        {
+            body_slots.capacity *= 2;
+            body_slots.slots = realloc(body_slots.slots, body_slots.capacity * sizeof(body_slot_t));
+            assert(body_slots.slots != NULL);
+        }
+        assert(body_slots.size < NO_FREE_SLOT);
+        index = (uint32_t)body_slots.size++;
+        body_slots.slots[index].generation = 1;
+    }
+
+    body_slot_t *slot = &body_slots.slots[index];
+    slot->body = body;
+    slot->next_free = NO_FREE_SLOT;
+    body_slots.live++;
+    return (body_handle_t){.index = index, .generation = slot->generation};
+}
+
+void body_slot_release(body_handle_t handle)
+{
+    body_slot_t *slot = &body_slots.slots[handle.index];
+    assert(slot->body != NULL && slot->generation == handle.generation);
+    slot->body = NULL;
+    // skip 0 when the generation wraps around, it is reserved for BODY_HANDLE_NONE
+    slot->generation = slot->generation == UINT32_MAX ? 1 : slot->generation + 1;
+    slot->next_free = body_slots.free_head;
+    body_slots.free_head = handle.index;
+    body_slots.live--;
+}
+
+void body_point_to_own_state(body_t *body)
+{
+    body->centroid = &body->own_state.centroid;
+    body->previous_centroid = &body->own_state.previous_centroid;
+    body->velocity = &body->own_state.velocity;
+    body->forces = &body->own_state.forces;
+    body->impulses = &body->own_state.impulses;
+    body->mass = &body->own_state.mass;
+}
+
+void body_point_to_store(body_t *body)
+{
+    body_store_t *store = body->store;
+    size_t slot = body->slot;
+    body->centroid = &store->centroids[slot];
+    body->previous_centroid = &store->previous_centroids[slot];
+    body->velocity = &store->velocities[slot];
+    body->forces = &store->forces[slot];
+    body->impulses = &store->impulses[slot];
+    body->mass = &store->masses[slot];
+}
+
+// the vertices are only translated when they are needed, so moving a body is O(1)
+void body_sync_shape(body_t *body)
+{
+    vector_t change = vec_subtract(*body->centroid, body->shape_centroid);
+    if (change.x != 0 || change.y != 0)
+    {
+        polygon_packed_translate(body->shape, change);
+        body->shape_centroid = *body->centroid;
+    }
+}
+
+// a rectangle whose edges are all horizontal or vertical
+bool body_shape_is_aabb(body_t *body, double tolerance)
+{
+    const vector_t *points = body->shape->points;
+    size_t size = body->shape->size;
+    if (size != 4)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < size; i++)
+    {
+        vector_t edge = vec_subtract(points[(i + 1) % size], points[i]);
+        if (fabs(edge.x) > tolerance && fabs(edge.y) > tolerance)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// vertices all the same distance from the centroid and evenly spaced
+bool body_shape_is_regular(body_t *body, double tolerance)
+{
+    const vector_t *points = body->shape->points;
+    size_t size = body->shape->size;
+    if (size < MIN_CIRCLE_POINTS)
+    {
+        return false;
+    }
+    vector_t centroid = body->shape_centroid;
+    double radius = vec_distance(points[0], centroid);
+    double edge_length = vec_distance(points[1], points[0]);
+    for (size_t i = 0; i < size; i++)
+    {
+        if (fabs(vec_distance(points[i], centroid) - radius) > tolerance)
+        {
+            return false;
+        }
+        // polygon_make_circle() can repeat its first vertex at the end, so skip empty edges
+        double length = vec_distance(points[(i + 1) % size], points[i]);
+        if (length > tolerance && fabs(length - edge_length) > tolerance)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void body_classify_shape(body_t *body)
+{
+    double tolerance = SHAPE_TOLERANCE * body->size;
+    body->radius = 0;
+    body->half_extents = VEC_ZERO;
+    if (body_shape_is_aabb(body, tolerance))
+    {
+        body->shape_kind = SHAPE_AABB;
+        const vector_t *points = body->shape->points;
+        // opposite corners are two vertices apart
+        body->half_extents = (vector_t){.x = fabs(points[2].x - points[0].x) / 2,
+                                        .y = fabs(points[2].y - points[0].y) / 2};
+    }
+    else if (body_shape_is_regular(body, tolerance))
+    {
+        body->shape_kind = SHAPE_CIRCLE;
+        body->radius = vec_distance(body->shape->points[0], body->shape_centroid);
+    }
+    else
+    {
+        body->shape_kind = SHAPE_POLYGON;
+    }
+}
+
+void body_move_attachments(body_t *body)
+{
+    if (body->image)
+    {
+        image_set_position(body->image, *body->centroid);
+    }
+    if (body->label)
+    {
+        text_set_position(body->label, *body->centroid);
+    }
+}
+
 body_t *body_init(list_t *shape, double mass, rgb_color_t color)
 {
     return body_init_with_info(shape, mass, color, NULL, NULL);
@@ -30,8 +274,9 @@ body_t *body_init_with_info_with_image(list_t *shape, double mass, rgb_color_t c
                                        vector_t image_size)
 {
     body_t *body = body_init_with_info(shape, mass, color, info, info_freer);
-    body->image = image_init(image_filename, body->centroid,
+    body->image = image_init(image_filename, *body->centroid,
                              vec_multiply(SIZE_MULTIPLIER, image_size), image_type);
+    body->image->owner = body;
     return body;
 }
 
@@ -40,49 +285,101 @@ body_t *body_init_with_info_with_label(list_t *shape, double mass, rgb_color_t b
                                        rgb_color_t text_color, TTF_Font *font, vector_t text_size)
 {
     body_t *body = body_init_with_info(shape, mass, body_color, info, info_freer);
-    body->label = text_init(text, body->centroid,
+    body->label = text_init(text, *body->centroid,
                             vec_multiply(SIZE_MULTIPLIER, text_size), text_color, font);
+    body->label->owner = body;
     return body;
 }
 
 body_t *body_init_with_info(list_t *shape, double mass, rgb_color_t color, void *info, free_func_t info_freer)
 {
-    body_t *b = malloc(sizeof(body_t));
-    assert(b != NULL);
+    body_t *b = body_init_with_shape(polygon_from_list(shape), mass, color, info, info_freer);
+    b->owns_shape = true;
+    list_free(shape);
+    return b;
+}
+
+body_t *body_init_with_shape(polygon_t *shape, double mass, rgb_color_t color, void *info, free_func_t info_freer)
+{
+    if (body_pool == NULL)
+    {
+        body_pool = pool_init(sizeof(body_t), BODY_POOL_BLOCK_SIZE);
+    }
+    body_t *b = pool_alloc(body_pool);
     b->shape = shape;
-    b->mass = mass;
+    b->owns_shape = false;
     b->color = color;
-    b->velocity = VEC_ZERO;
-    b->centroid = polygon_centroid(shape);
     b->angle = 0.0;
-    b->forces = VEC_ZERO;
-    b->impulses = VEC_ZERO;
     b->remove_flag = false;
     b->info = info;
     b->info_freer = info_freer;
-    b->size = polygon_max_distance_across(shape);
+    b->type = 0;
+    b->size = polygon_packed_max_distance_across(b->shape);
     b->image = NULL;
     b->label = NULL;
+    b->store = NULL;
+    b->slot = 0;
+    b->handle = body_slot_acquire(b);
+    vector_t centroid = polygon_packed_centroid(b->shape);
+    b->own_state = (body_state_t){.centroid = centroid,
+                                  .previous_centroid = centroid,
+                                  .velocity = VEC_ZERO,
+                                  .forces = VEC_ZERO,
+                                  .impulses = VEC_ZERO,
+                                  .mass = mass};
+    b->shape_centroid = b->own_state.centroid;
+    body_point_to_own_state(b);
+    body_classify_shape(b);
     return b;
 }
 
 void body_free(body_t *body)
 {
-    list_free(body->shape);
+    if (body->store != NULL)
+    {
+        body_store_remove(body->store, body);
+    }
+    if (body->owns_shape)
+    {
+        polygon_free(body->shape);
+    }
     if (body->info_freer != NULL)
     {
         body->info_freer(body->info);
     }
+    // the scene frees them after the body, so they mustn't point back to it
     if (body->image)
     {
         image_remove(body->image);
+        body->image->owner = NULL;
     }
     if (body->label)
     {
         text_remove(body->label);
+        body->label->owner = NULL;
+    }
+    body_slot_release(body->handle);
+    pool_release(body);
+}
+
+body_handle_t body_get_handle(body_t *body)
+{
+    return body->handle;
+}
+
+body_t *body_from_handle(body_handle_t handle)
+{
+    if (handle.index >= body_slots.size)
+    {
+        return NULL;
     }
-    body = NULL;
-    free(body);
+    body_slot_t *slot = &body_slots.slots[handle.index];
+    return slot->generation == handle.generation ? slot->body : NULL;
+}
+
+size_t body_count(void)
+{
+    return body_slots.live;
 }
 
 double body_get_size(body_t *body)
@@ -90,50 +387,68 @@ double body_get_size(body_t *body)
     return body->size;
 }
 
+shape_kind_t body_get_shape_kind(body_t *body)
+{
+    return body->shape_kind;
+}
+
+double body_get_radius(body_t *body)
+{
+    return body->radius;
+}
+
+vector_t body_get_half_extents(body_t *body)
+{
+    return body->half_extents;
+}
+
 list_t *body_get_shape(body_t *body)
 {
-    size_t shape_size = list_size(body->shape);
-    list_t *shape = list_init(shape_size, free);
-    for (size_t i = 0; i < shape_size; i++)
-    {
-        vector_t *old_point = list_get(body->shape, i);
-        vector_t *new_point = malloc(sizeof(vector_t));
-        assert(new_point != NULL);
-        new_point->x = old_point->x;
-        new_point->y = old_point->y;
-        list_add(shape, new_point);
-    }
-    return shape;
+    body_sync_shape(body);
+    return polygon_to_list(body->shape);
+}
+
+const vector_t *body_peek_shape(body_t *body, size_t *num_points)
+{
+    body_sync_shape(body);
+    *num_points = body->shape->size;
+    return body->shape->points;
 }
 
 vector_t body_get_centroid(body_t *body)
 {
-    return body->centroid;
+    return *body->centroid;
+}
+
+vector_t body_get_interpolated_centroid(body_t *body, double alpha)
+{
+    vector_t change = vec_subtract(*body->centroid, *body->previous_centroid);
+    return vec_add(*body->previous_centroid, vec_multiply(alpha, change));
 }
 
 vector_t body_get_forces(body_t *body)
 {
-    return body->forces;
+    return *body->forces;
 }
 
 vector_t body_get_impulses(body_t *body)
 {
-    return body->impulses;
+    return *body->impulses;
 }
 
 vector_t body_get_velocity(body_t *body)
 {
-    return body->velocity;
+    return *body->velocity;
 }
 
 double body_get_mass(body_t *body)
 {
-    return body->mass;
+    return *body->mass;
 }
 
 void body_set_mass(body_t *body, double new_mass)
 {
-    body->mass = new_mass;
+    *body->mass = new_mass;
 }
 
 rgb_color_t body_get_color(body_t *body)
@@ -151,52 +466,199 @@ void body_set_info(body_t *body, void *info)
     body->info = info;
 }
 
+int body_get_type(body_t *body)
+{
+    return body->type;
+}
+
+void body_set_type(body_t *body, int type)
+{
+    assert(type >= 0);
+    body->type = type;
+}
+
 void body_set_centroid(body_t *body, vector_t x)
 {
-    vector_t change = vec_subtract(x, body->centroid);
-    polygon_translate(body->shape, change);
-    body->centroid = vec_add(body->centroid, change);
+    // a teleport, so don't interpolate from the old position
+    *body->centroid = x;
+    *body->previous_centroid = x;
 }
 
 void body_set_velocity(body_t *body, vector_t v)
 {
-    body->velocity = v;
+    *body->velocity = v;
 }
 
 void body_set_rotation(body_t *body, double angle)
 {
-    polygon_rotate(body->shape, angle - body->angle, body->centroid);
+    body_sync_shape(body);
+    polygon_packed_rotate(body->shape, angle - body->angle, *body->centroid);
     body->angle = angle;
+    body_classify_shape(body);
 }
 
 void body_add_force(body_t *body, vector_t force)
 {
-    body->forces = vec_add(body->forces, force);
+    *body->forces = vec_add(*body->forces, force);
 }
 
 void body_add_impulse(body_t *body, vector_t impulse)
 {
-    body->impulses = vec_add(body->impulses, impulse);
+    *body->impulses = vec_add(*body->impulses, impulse);
 }
 
 void body_tick(body_t *body, double dt)
 {
-    vector_t old_vel = body->velocity;
-    body->velocity = vec_add(body->velocity, vec_multiply(dt / body->mass, body->forces));
-    body->forces = VEC_ZERO;
-    body->velocity = vec_add(body->velocity, vec_multiply(1.0 / body->mass, body->impulses));
-    body->impulses = VEC_ZERO;
-    vector_t avg_vel = vec_multiply(0.5, vec_add(old_vel, body->velocity));
+    vector_t old_vel = *body->velocity;
+    vector_t velocity = vec_add(old_vel, vec_multiply(dt / *body->mass, *body->forces));
+    *body->forces = VEC_ZERO;
+    velocity = vec_add(velocity, vec_multiply(1.0 / *body->mass, *body->impulses));
+    *body->impulses = VEC_ZERO;
+    *body->velocity = velocity;
+    vector_t avg_vel = vec_multiply(0.5, vec_add(old_vel, velocity));
     vector_t displacement = vec_multiply(dt, avg_vel);
-    polygon_translate(body->shape, displacement);
-    body->centroid = vec_add(body->centroid, displacement);
-    if (body->image)
+    *body->previous_centroid = *body->centroid;
+    *body->centroid = vec_add(*body->centroid, displacement);
+    body_move_attachments(body);
+}
+
+body_store_t *body_store_init(void)
+{
+    body_store_t *store = malloc(sizeof(body_store_t));
+    assert(store != NULL);
+    *store = (body_store_t){.bodies = NULL, .centroids = NULL, .previous_centroids = NULL, .velocities = NULL,
+                            .forces = NULL, .impulses = NULL, .masses = NULL,
+                            .attached = NULL, .size = 0, .capacity = 0};
+    body_store_resize(store, INITIAL_STORE_CAPACITY);
+    return store;
+}
+
+void body_store_free(body_store_t *store)
+{
+    while (store->size > 0)
     {
-        image_set_position(body->image, body->centroid);
+        body_store_remove(store, store->bodies[store->size - 1]);
     }
-    if (body->label)
+    free(store->bodies);
+    free(store->centroids);
+    free(store->previous_centroids);
+    free(store->velocities);
+    free(store->forces);
+    free(store->impulses);
+    free(store->masses);
+    free(store->attached);
+    free(store);
+}
+
+void body_store_resize(body_store_t *store, size_t capacity)
+{
+    store->bodies = realloc(store->bodies, capacity * sizeof(body_t *));
+    store->centroids = realloc(store->centroids, capacity * sizeof(vector_t));
+    store->previous_centroids = realloc(store->previous_centroids, capacity * sizeof(vector_t));
+    store->velocities = realloc(store->velocities, capacity * sizeof(vector_t));
+    store->forces = realloc(store->forces, capacity * sizeof(vector_t));
+    store->impulses = realloc(store->impulses, capacity * sizeof(vector_t));
+    store->masses = realloc(store->masses, capacity * sizeof(double));
+    store->attached = realloc(store->attached, capacity * sizeof(bool));
+    assert(store->bodies != NULL && store->centroids != NULL && store->previous_centroids != NULL);
+    assert(store->velocities != NULL);
+    assert(store->forces != NULL && store->impulses != NULL && store->masses != NULL);
+    assert(store->attached != NULL);
+    store->capacity = capacity;
+
+    // the arrays may have moved
+    for (size_t i = 0; i < store->size; i++)
+    {
+        body_point_to_store(store->bodies[i]);
+    }
+}
+
+void body_store_add(body_store_t *store, body_t *body)
+{
+    assert(body->store == NULL);
+    if (store->size >= store->capacity)
+    {
+        body_store_resize(store, store->capacity * 2);
+    }
+    size_t slot = store->size++;
+    store->bodies[slot] = body;
+    store->centroids[slot] = body->own_state.centroid;
+    store->previous_centroids[slot] = body->own_state.previous_centroid;
+    store->velocities[slot] = body->own_state.velocity;
+    store->forces[slot] = body->own_state.forces;
+    store->impulses[slot] = body->own_state.impulses;
+    store->masses[slot] = body->own_state.mass;
+    store->attached[slot] = body->image != NULL || body->label != NULL;
+    body->store = store;
+    body->slot = slot;
+    body_point_to_store(body);
+}
+
+void body_store_remove(body_store_t *store, body_t *body)
+{
+    assert(body->store == store);
+    size_t slot = body->slot;
+    body->own_state = (body_state_t){.centroid = store->centroids[slot],
+                                     .previous_centroid = store->previous_centroids[slot],
+                                     .velocity = store->velocities[slot],
+                                     .forces = store->forces[slot],
+                                     .impulses = store->impulses[slot],
+                                     .mass = store->masses[slot]};
+    body->store = NULL;
+    body_point_to_own_state(body);
+
+    // move the last body into the freed slot
+    size_t last = --store->size;
+    if (slot != last)
+    {
+        body_t *moved = store->bodies[last];
+        store->bodies[slot] = moved;
+        store->centroids[slot] = store->centroids[last];
+        store->previous_centroids[slot] = store->previous_centroids[last];
+        store->velocities[slot] = store->velocities[last];
+        store->forces[slot] = store->forces[last];
+        store->impulses[slot] = store->impulses[last];
+        store->masses[slot] = store->masses[last];
+        store->attached[slot] = store->attached[last];
+        moved->slot = slot;
+        body_point_to_store(moved);
+    }
+}
+
+void body_store_tick(body_store_t *store, double dt)
+{
+    size_t size = store->size;
+    vector_t *restrict centroids = store->centroids;
+    vector_t *restrict previous_centroids = store->previous_centroids;
+    vector_t *restrict velocities = store->velocities;
+    vector_t *restrict forces = store->forces;
+    vector_t *restrict impulses = store->impulses;
+    const double *restrict masses = store->masses;
+
+    // same integration as body_tick(), over plain arrays so it can be vectorized
+    for (size_t i = 0; i < size; i++)
     {
-        text_set_position(body->label, body->centroid);
+        double force_scale = dt / masses[i];
+        double impulse_scale = 1.0 / masses[i];
+        vector_t old_vel = velocities[i];
+        vector_t velocity = {.x = old_vel.x + force_scale * forces[i].x,
+                             .y = old_vel.y + force_scale * forces[i].y};
+        velocity.x += impulse_scale * impulses[i].x;
+        velocity.y += impulse_scale * impulses[i].y;
+        velocities[i] = velocity;
+        previous_centroids[i] = centroids[i];
+        centroids[i].x += dt * (0.5 * (old_vel.x + velocity.x));
+        centroids[i].y += dt * (0.5 * (old_vel.y + velocity.y));
+        forces[i] = VEC_ZERO;
+        impulses[i] = VEC_ZERO;
+    }
+
+    for (size_t i = 0; i < size; i++)
+    {
+        if (store->attached[i])
+        {
+            body_move_attachments(store->bodies[i]);
+        }
     }
 }
 
@@ -230,7 +692,19 @@ image_t *body_get_image(body_t *body)
 
 void body_set_image(body_t *body, image_t *image)
 {
+    if (body->image != NULL)
+    {
+        body->image->owner = NULL;
+    }
     body->image = image;
+    if (image != NULL)
+    {
+        image->owner = body;
+    }
+    if (body->store != NULL)
+    {
+        body->store->attached[body->slot] = image != NULL || body->label != NULL;
+    }
 }
 
 text_t *body_get_label(body_t *body)
@@ -2,11 +2,41 @@
 #include "scene.h"
 #include "forces.h"
 #include "tower.h"
+#include "pool.h"
 
 const double BULLET_RADIUS = 5.0;
-const size_t BULLET_NUM_POINTS = 5;
+#define BULLET_NUM_POINTS 5
 const double BULLET_MASS = 10.0;
 const vector_t BOMB_IMG_SIZE = {.x = 50, .y = 50};
+const size_t BULLET_POOL_BLOCK_SIZE = 256;
+
+// a bullet's global body info and bullet info, taken from the pool together
+typedef struct bullet_info_block
+{
+    global_body_info_t global; // first, so the body's info is the pooled object itself
+    bullet_t bullet;
+    polygon_t shape; // the body's shape, so spawning a bullet never reaches malloc
+    vector_t points[BULLET_NUM_POINTS];
+} bullet_info_block_t;
+
+pool_t *bullet_info_pool = NULL;
+
+// private
+body_t *bullet_body_init(vector_t position, rgb_color_t color, bullet_t bullet_info)
+{
+    if (bullet_info_pool == NULL)
+    {
+        bullet_info_pool = pool_init(sizeof(bullet_info_block_t), BULLET_POOL_BLOCK_SIZE);
+    }
+    bullet_info_block_t *block = pool_alloc(bullet_info_pool);
+    block->bullet = bullet_info;
+    block->global = (global_body_info_t){.secondary_info = &block->bullet};
+    polygon_fill_circle(block->points, position, BULLET_RADIUS, BULLET_NUM_POINTS);
+    block->shape = (polygon_t){.points = block->points, .size = BULLET_NUM_POINTS};
+    body_t *bullet = body_init_with_shape(&block->shape, BULLET_MASS, color, &block->global, pool_release);
+    body_set_type(bullet, BULLET_TYPE);
+    return bullet;
+}
 
 // private
 void bullet_delete_out_of_window(body_t *bullet, body_t *wall, vector_t axis, scene_t *scene)
@@ -14,25 +44,28 @@ void bullet_delete_out_of_window(body_t *bullet, body_t *wall, vector_t axis, sc
     body_remove(bullet);
 }
 
-body_t *create_basic_bullet(scene_t *scene, vector_t position, rgb_color_t color, bullet_t bullet_info)
+// private
+void virus_bullet_hit(body_t *virus, body_t *bullet, vector_t axis, game_state_t *game_state)
 {
-    bullet_t *info = malloc(sizeof(bullet_t));
-    *info = bullet_info;
-    list_t *shape = polygon_make_circle(position, BULLET_RADIUS, BULLET_NUM_POINTS);
-    body_t *bullet = body_init_with_secondary_info(shape, BULLET_MASS, color, info, free, BULLET_TYPE);
-    scene_add_body(scene, bullet);
-
-    // add collision force with playing window borders to detect when viruses complete the path
-    for (size_t i = 0; i < scene_bodies(scene); i++)
+    bullet_t *info = get_global_secondary_info(bullet);
+    if (info->virus_handler != NULL)
     {
-        body_t *curr_body = scene_get_body(scene, i);
-        // if bullet hits a wall
-        if (get_global_type(curr_body) == WALL_TYPE)
-        {
-            create_collision(scene, bullet, curr_body, (collision_handler_t)bullet_delete_out_of_window, scene, NULL);
-        }
+        info->virus_handler(virus, bullet, axis, game_state);
     }
+}
 
+void bullet_add_collision_rules(scene_t *scene, game_state_t *game_state)
+{
+    scene_add_collision_rule(scene, VIRUS_TYPE, BULLET_TYPE,
+                             (collision_handler_t)virus_bullet_hit, game_state, NULL);
+    scene_add_collision_rule(scene, BULLET_TYPE, WALL_TYPE,
+                             (collision_handler_t)bullet_delete_out_of_window, scene, NULL);
+}
+
+body_t *create_basic_bullet(scene_t *scene, vector_t position, rgb_color_t color, bullet_t bullet_info)
+{
+    body_t *bullet = bullet_body_init(position, color, bullet_info);
+    scene_add_body(scene, bullet);
     return bullet;
 }
 
@@ -41,10 +74,7 @@ body_t *create_explosion_effect_bullet(scene_t *scene, vector_t position)
 
     rgb_color_t color = BLACK;
 
-    bullet_t *info = malloc(sizeof(bullet_t));
-    *info = (bullet_t){0, 0, 0, 0, 3}; // 3 alive ticks
-    list_t *shape = polygon_make_circle(position, BULLET_RADIUS, BULLET_NUM_POINTS);
-    body_t *bullet = body_init_with_secondary_info(shape, BULLET_MASS, color, info, free, BULLET_TYPE);
+    body_t *bullet = bullet_body_init(position, color, (bullet_t){0, 0, 0, 0, 3, NULL}); // 3 alive ticks
 
     image_t *image = image_init("images/bomb.png", position, BOMB_IMG_SIZE, IMG_INIT_PNG);
     body_set_image(bullet, image);
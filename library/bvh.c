@@ -0,0 +1,288 @@
+#include <math.h>
+#include "bvh.h"
+
+const size_t BVH_LEAF_SIZE = 4;
+const size_t BVH_NO_ENTRY = SIZE_MAX;
+// the bodies are halved at each level, so the stack never holds more than two nodes per level
+#define BVH_MAX_DEPTH 128
+
+typedef struct bvh_entry
+{
+    body_t *body;
+    vector_t min;
+    vector_t max;
+    vector_t center;
+    size_t leaf;           // the node the entry is in
+    uint32_t handle_index; // the index of the body's handle, which entry_of is keyed by
+} bvh_entry_t;
+
+// leaves cover entries[start, start + count), inner nodes have children left and left + 1
+typedef struct bvh_node
+{
+    vector_t min;
+    vector_t max;
+    size_t start;
+    size_t count;
+    size_t left; // 0 for leaves, the root is never a child
+    size_t parent; // 0 for the root
+} bvh_node_t;
+
+typedef struct bvh
+{
+    bvh_entry_t *entries;
+    size_t size;
+    size_t entry_capacity;
+    bvh_node_t *nodes;
+    size_t num_nodes;
+    size_t node_capacity;
+    size_t *entry_of; // by body handle index, where the body is in entries, or BVH_NO_ENTRY
+    size_t entry_of_capacity;
+} bvh_t;
+
+// PRIVATE HELPER FUNCTION DECLARATIONS
+void bvh_build_node(bvh_t *bvh, size_t index, size_t start, size_t count);
+size_t bvh_add_node(bvh_t *bvh);
+int bvh_compare_x(const void *e1, const void *e2);
+int bvh_compare_y(const void *e1, const void *e2);
+bool bvh_box_near(vector_t min, vector_t max, vector_t center, double radius);
+void bvh_entry_bound(bvh_entry_t *entry, body_t *body);
+
+bvh_t *bvh_init(void)
+{
+    bvh_t *bvh = malloc(sizeof(bvh_t));
+    assert(bvh != NULL);
+    *bvh = (bvh_t){.entries = NULL, .size = 0, .entry_capacity = 0,
+                   .nodes = NULL, .num_nodes = 0, .node_capacity = 0,
+                   .entry_of = NULL, .entry_of_capacity = 0};
+    return bvh;
+}
+
+void bvh_free(bvh_t *bvh)
+{
+    free(bvh->entries);
+    free(bvh->nodes);
+    free(bvh->entry_of);
+    free(bvh);
+}
+
+int bvh_compare_x(const void *e1, const void *e2)
+{
+    double x1 = ((const bvh_entry_t *)e1)->center.x;
+    double x2 = ((const bvh_entry_t *)e2)->center.x;
+    return (x1 > x2) - (x1 < x2);
+}
+
+int bvh_compare_y(const void *e1, const void *e2)
+{
+    double y1 = ((const bvh_entry_t *)e1)->center.y;
+    double y2 = ((const bvh_entry_t *)e2)->center.y;
+    return (y1 > y2) - (y1 < y2);
+}
+
+size_t bvh_add_node(bvh_t *bvh)
+{
+    if (bvh->num_nodes >= bvh->node_capacity)
+    {
+        bvh->node_capacity = bvh->node_capacity == 0 ? BVH_LEAF_SIZE : bvh->node_capacity * 2;
+        bvh->nodes = realloc(bvh->nodes, bvh->node_capacity * sizeof(bvh_node_t));
+        assert(bvh->nodes != NULL);
+    }
+    return bvh->num_nodes++;
+}
+
+void bvh_build_node(bvh_t *bvh, size_t index, size_t start, size_t count)
+{
+    vector_t min = {HUGE_VAL, HUGE_VAL};
+    vector_t max = {-HUGE_VAL, -HUGE_VAL};
+    vector_t center_min = {HUGE_VAL, HUGE_VAL};
+    vector_t center_max = {-HUGE_VAL, -HUGE_VAL};
+    for (size_t i = start; i < start + count; i++)
+    {
+        bvh_entry_t *entry = &bvh->entries[i];
+        min = (vector_t){fmin(min.x, entry->min.x), fmin(min.y, entry->min.y)};
+        max = (vector_t){fmax(max.x, entry->max.x), fmax(max.y, entry->max.y)};
+        center_min = (vector_t){fmin(center_min.x, entry->center.x), fmin(center_min.y, entry->center.y)};
+        center_max = (vector_t){fmax(center_max.x, entry->center.x), fmax(center_max.y, entry->center.y)};
+    }
+    size_t parent = bvh->nodes[index].parent;
+    bvh->nodes[index] = (bvh_node_t){.min = min, .max = max, .start = start, .count = count, .left = 0,
+                                     .parent = parent};
+    if (count <= BVH_LEAF_SIZE)
+    {
+        for (size_t i = start; i < start + count; i++)
+        {
+            bvh->entries[i].leaf = index;
+        }
+        return;
+    }
+
+    // split at the median along the axis the centers are most spread out on
+    bool split_x = center_max.x - center_min.x >= center_max.y - center_min.y;
+    qsort(&bvh->entries[start], count, sizeof(bvh_entry_t), split_x ? bvh_compare_x : bvh_compare_y);
+    size_t half = count / 2;
+    size_t left = bvh_add_node(bvh);
+    bvh_add_node(bvh);
+    bvh->nodes[index].left = left;
+    bvh->nodes[left].parent = index;
+    bvh->nodes[left + 1].parent = index;
+    bvh_build_node(bvh, left, start, half);
+    bvh_build_node(bvh, left + 1, start + half, count - half);
+}
+
+void bvh_build(bvh_t *bvh, list_t *bodies)
+{
+    // the old entries' bodies may be gone, so forget them by the handle index they kept
+    for (size_t i = 0; i < bvh->size; i++)
+    {
+        bvh->entry_of[bvh->entries[i].handle_index] = BVH_NO_ENTRY;
+    }
+    size_t size = list_size(bodies);
+    if (size > bvh->entry_capacity)
+    {
+        bvh->entry_capacity = size;
+        bvh->entries = realloc(bvh->entries, size * sizeof(bvh_entry_t));
+        assert(bvh->entries != NULL);
+    }
+    for (size_t i = 0; i < size; i++)
+    {
+        bvh_entry_bound(&bvh->entries[i], list_get(bodies, i));
+    }
+    bvh->size = size;
+    bvh->num_nodes = 0;
+    if (size > 0)
+    {
+        size_t root = bvh_add_node(bvh);
+        bvh->nodes[root].parent = 0;
+        bvh_build_node(bvh, root, 0, size);
+    }
+    // after building, since that sorts the entries
+    for (size_t i = 0; i < size; i++)
+    {
+        size_t handle_index = bvh->entries[i].handle_index;
+        if (handle_index >= bvh->entry_of_capacity)
+        {
+            size_t capacity = bvh->entry_of_capacity == 0 ? BVH_LEAF_SIZE : bvh->entry_of_capacity;
+            while (capacity <= handle_index)
+            {
+                capacity *= 2;
+            }
+            bvh->entry_of = realloc(bvh->entry_of, capacity * sizeof(size_t));
+            assert(bvh->entry_of != NULL);
+            for (size_t j = bvh->entry_of_capacity; j < capacity; j++)
+            {
+                bvh->entry_of[j] = BVH_NO_ENTRY;
+            }
+            bvh->entry_of_capacity = capacity;
+        }
+        bvh->entry_of[handle_index] = i;
+    }
+}
+
+void bvh_entry_bound(bvh_entry_t *entry, body_t *body)
+{
+    size_t num_points;
+    const vector_t *points = body_peek_shape(body, &num_points);
+    vector_t min = {HUGE_VAL, HUGE_VAL};
+    vector_t max = {-HUGE_VAL, -HUGE_VAL};
+    for (size_t j = 0; j < num_points; j++)
+    {
+        min = (vector_t){fmin(min.x, points[j].x), fmin(min.y, points[j].y)};
+        max = (vector_t){fmax(max.x, points[j].x), fmax(max.y, points[j].y)};
+    }
+    *entry = (bvh_entry_t){.body = body, .min = min, .max = max,
+                           .center = vec_multiply(0.5, vec_add(min, max)), .leaf = entry->leaf,
+                           .handle_index = body_get_handle(body).index};
+}
+
+bool bvh_refit(bvh_t *bvh, body_t *body)
+{
+    uint32_t handle_index = body_get_handle(body).index;
+    if (handle_index >= bvh->entry_of_capacity || bvh->entry_of[handle_index] == BVH_NO_ENTRY)
+    {
+        return false;
+    }
+    bvh_entry_t *entry = &bvh->entries[bvh->entry_of[handle_index]];
+    if (entry->body != body)
+    {
+        return false;
+    }
+    bvh_entry_bound(entry, body);
+
+    // the leaf's box covers its entries, and every box above covers its two children
+    size_t index = entry->leaf;
+    while (true)
+    {
+        bvh_node_t *node = &bvh->nodes[index];
+        vector_t min = {HUGE_VAL, HUGE_VAL};
+        vector_t max = {-HUGE_VAL, -HUGE_VAL};
+        if (node->left == 0)
+        {
+            for (size_t i = node->start; i < node->start + node->count; i++)
+            {
+                min = (vector_t){fmin(min.x, bvh->entries[i].min.x), fmin(min.y, bvh->entries[i].min.y)};
+                max = (vector_t){fmax(max.x, bvh->entries[i].max.x), fmax(max.y, bvh->entries[i].max.y)};
+            }
+        }
+        else
+        {
+            for (size_t child = node->left; child <= node->left + 1; child++)
+            {
+                min = (vector_t){fmin(min.x, bvh->nodes[child].min.x), fmin(min.y, bvh->nodes[child].min.y)};
+                max = (vector_t){fmax(max.x, bvh->nodes[child].max.x), fmax(max.y, bvh->nodes[child].max.y)};
+            }
+        }
+        node->min = min;
+        node->max = max;
+        if (index == 0)
+        {
+            return true;
+        }
+        index = node->parent;
+    }
+}
+
+bool bvh_box_near(vector_t min, vector_t max, vector_t center, double radius)
+{
+    double dx = fmax(0, fmax(min.x - center.x, center.x - max.x));
+    double dy = fmax(0, fmax(min.y - center.y, center.y - max.y));
+    return dx * dx + dy * dy <= radius * radius;
+}
+
+void bvh_query_circle(bvh_t *bvh, vector_t center, double radius, list_t *results)
+{
+    if (bvh->num_nodes == 0)
+    {
+        return;
+    }
+    size_t stack[BVH_MAX_DEPTH];
+    size_t top = 0;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+        bvh_node_t *node = &bvh->nodes[stack[--top]];
+        if (!bvh_box_near(node->min, node->max, center, radius))
+        {
+            continue;
+        }
+        if (node->left != 0)
+        {
+            assert(top + 2 <= BVH_MAX_DEPTH);
+            stack[top++] = node->left + 1;
+            stack[top++] = node->left;
+            continue;
+        }
+        for (size_t i = node->start; i < node->start + node->count; i++)
+        {
+            bvh_entry_t *entry = &bvh->entries[i];
+            if (bvh_box_near(entry->min, entry->max, center, radius))
+            {
+                list_add(results, entry->body);
+            }
+        }
+    }
+}
+
+size_t bvh_bodies(bvh_t *bvh)
+{
+    return bvh->size;
+}
@@ -1,4 +1,12 @@
 #include "collision.h"
+#include "profile.h"
+#include "arena.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
 
 typedef struct
 {
@@ -6,46 +14,37 @@ typedef struct
     double max;
 } projection_range_t;
 
+typedef projection_range_t (*projector_t)(const vector_t *shape, size_t size, vector_t axis);
+
 // PRIVATE HELPER FUNCTION DECLARATIONS
-list_t *get_projection_axes(list_t *shapes);
-projection_range_t get_projection_range(list_t *shape, vector_t *axis);
+void add_projection_axes(vector_t *axes, const vector_t *shape, size_t size);
+projection_range_t get_projection_range(const vector_t *shape, size_t size, vector_t axis);
+projection_range_t get_projection_range_simd(const vector_t *shape, size_t size, vector_t axis);
+collision_info_t find_separating_axis(const vector_t *shape1, size_t size1,
+                                      const vector_t *shape2, size_t size2, projector_t project);
 
-list_t *get_projection_axes(list_t *shapes)
+void add_projection_axes(vector_t *axes, const vector_t *shape, size_t size)
 {
-    assert(list_size(shapes) == 2);
-    list_t *axes = list_init(list_size(list_get(shapes, 0)) + list_size(list_get(shapes, 1)), (free_func_t)free);
-
-    for (size_t s = 0; s < list_size(shapes); s++)
+    for (size_t v1 = 0; v1 < size; v1++)
     {
-        list_t *shape = list_get(shapes, s);
-        for (size_t v1 = 0; v1 < list_size(shape); v1++)
-        {
-            // get adjacent edge, making sure to wrap around at the end
-            size_t v2 = (v1 + 1) % (list_size(shape) - 1);
-
-            // getting the perpendicular unit axis
-            vector_t edge = vec_unit(vec_subtract(*((vector_t *)list_get(shape, v1)),
-                                                  *((vector_t *)list_get(shape, v2))));
-            edge = vec_rotate(edge, M_PI / 2);
-            vector_t *axis = malloc(sizeof(vector_t));
-            axis->x = edge.x;
-            axis->y = edge.y;
-            list_add(axes, axis);
-        }
+        // get adjacent edge, making sure to wrap around at the end
+        size_t v2 = (v1 + 1) % (size - 1);
+
+        // getting the perpendicular unit axis
+        vector_t edge = vec_unit(vec_subtract(shape[v1], shape[v2]));
+        axes[v1] = (vector_t){-edge.y, edge.x};
     }
-    return axes;
 }
 
-projection_range_t get_projection_range(list_t *shape, vector_t *axis)
+projection_range_t get_projection_range(const vector_t *shape, size_t size, vector_t axis)
 {
     double min_projection = HUGE_VAL;
     double max_projection = -HUGE_VAL;
 
     // looping through the shape's vertices
-    for (size_t i = 0; i < list_size(shape); i++)
+    for (size_t i = 0; i < size; i++)
     {
-        vector_t vertex = *((vector_t *)list_get(shape, i));
-        double projection = vec_dot(vertex, *axis);
+        double projection = vec_dot(shape[i], axis);
 
         if (projection < min_projection)
         {
@@ -59,28 +58,103 @@ projection_range_t get_projection_range(list_t *shape, vector_t *axis)
     return (projection_range_t){.min = min_projection, .max = max_projection};
 }
 
-collision_info_t find_collision(list_t *shape1, list_t *shape2)
+// same as get_projection_range(), several vertices at a time
+projection_range_t get_projection_range_simd(const vector_t *shape, size_t size, vector_t axis)
+{
+    const double *coordinates = (const double *)shape; // x0, y0, x1, y1, ...
+    size_t i = 0;
+    double min_projection = HUGE_VAL;
+    double max_projection = -HUGE_VAL;
+#if defined(__AVX2__)
+    // the running range is the second operand, which is what min/max return for a NaN
+    // projection, so NaNs are skipped like the comparisons in get_projection_range() do
+    __m256d axis_x = _mm256_set1_pd(axis.x);
+    __m256d axis_y = _mm256_set1_pd(axis.y);
+    __m256d mins = _mm256_set1_pd(HUGE_VAL);
+    __m256d maxes = _mm256_set1_pd(-HUGE_VAL);
+    for (; i + 4 <= size; i += 4)
+    {
+        __m256d first = _mm256_loadu_pd(coordinates + 2 * i);      // x0 y0 x1 y1
+        __m256d second = _mm256_loadu_pd(coordinates + 2 * i + 4); // x2 y2 x3 y3
+        __m256d xs = _mm256_unpacklo_pd(first, second);            // x0 x2 x1 x3
+        __m256d ys = _mm256_unpackhi_pd(first, second);            // y0 y2 y1 y3
+        __m256d projections = _mm256_add_pd(_mm256_mul_pd(xs, axis_x), _mm256_mul_pd(ys, axis_y));
+        mins = _mm256_min_pd(projections, mins);
+        maxes = _mm256_max_pd(projections, maxes);
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, mins);
+    for (size_t lane = 0; lane < 4; lane++)
+    {
+        min_projection = fmin(min_projection, lanes[lane]);
+    }
+    _mm256_storeu_pd(lanes, maxes);
+    for (size_t lane = 0; lane < 4; lane++)
+    {
+        max_projection = fmax(max_projection, lanes[lane]);
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    // as above, NaN projections leave the running range alone
+    __m128d axis_x = _mm_set1_pd(axis.x);
+    __m128d axis_y = _mm_set1_pd(axis.y);
+    __m128d mins = _mm_set1_pd(HUGE_VAL);
+    __m128d maxes = _mm_set1_pd(-HUGE_VAL);
+    for (; i + 2 <= size; i += 2)
+    {
+        __m128d first = _mm_loadu_pd(coordinates + 2 * i);      // x0 y0
+        __m128d second = _mm_loadu_pd(coordinates + 2 * i + 2); // x1 y1
+        __m128d xs = _mm_unpacklo_pd(first, second);            // x0 x1
+        __m128d ys = _mm_unpackhi_pd(first, second);            // y0 y1
+        __m128d projections = _mm_add_pd(_mm_mul_pd(xs, axis_x), _mm_mul_pd(ys, axis_y));
+        mins = _mm_min_pd(projections, mins);
+        maxes = _mm_max_pd(projections, maxes);
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, mins);
+    min_projection = fmin(lanes[0], lanes[1]);
+    _mm_storeu_pd(lanes, maxes);
+    max_projection = fmax(lanes[0], lanes[1]);
+#endif
+    // the vertices left over, or all of them without SIMD
+    projection_range_t rest = get_projection_range(shape + i, size - i, axis);
+    return (projection_range_t){.min = fmin(min_projection, rest.min),
+                                .max = fmax(max_projection, rest.max)};
+}
+
+collision_info_t find_separating_axis(const vector_t *shape1, size_t size1,
+                                      const vector_t *shape2, size_t size2, projector_t project)
 {
-    list_t *shapes = list_init(2, NULL);
-    list_add(shapes, shape1);
-    list_add(shapes, shape2);
-    list_t *axes = get_projection_axes(shapes);
+    PROFILE_BEGIN(PROFILE_FIND_COLLISION);
+    PROFILE_COUNT(PROFILE_COLLISION_TESTS, 1);
+    size_t num_axes = size1 + size2;
+    arena_mark_t mark = arena_mark(frame_arena());
+    vector_t *axes = arena_alloc(frame_arena(), num_axes * sizeof(vector_t));
+    add_projection_axes(axes, shape1, size1);
+    add_projection_axes(axes + size1, shape2, size2);
 
     bool collided = true;
     double min_overlap = HUGE_VAL;
-    vector_t collision_axis = *((vector_t *)list_get(axes, 0));
+    vector_t collision_axis = axes[0];
 
-    for (size_t i = 0; i < list_size(axes); i++)
+    for (size_t i = 0; i < num_axes; i++)
     {
-        vector_t *axis = list_get(axes, i);
-        projection_range_t projection1 = get_projection_range(shape1, axis);
-        projection_range_t projection2 = get_projection_range(shape2, axis);
+        vector_t axis = axes[i];
+        projection_range_t projection1 = project(shape1, size1, axis);
+        projection_range_t projection2 = project(shape2, size2, axis);
 
         double min1 = projection1.min;
         double max1 = projection1.max;
         double min2 = projection2.min;
         double max2 = projection2.max;
 
+        if (min2 > max1 || max2 < min1) // the projections don't overlap
+        {
+            // one separating axis is enough
+            collided = false;
+            collision_axis = axis;
+            break;
+        }
+
         // two overlap possibilities depending on orientation of shapes relative to each other
         double overlap12 = fabs(max2 - min1);
         double overlap21 = fabs(max1 - min2);
@@ -88,19 +162,119 @@ collision_info_t find_collision(list_t *shape1, list_t *shape2)
 
         if (min < min_overlap)
         {
-            collision_axis.x = axis->x;
-            collision_axis.y = axis->y;
+            collision_axis = axis;
             min_overlap = min;
         }
-
-        if (min2 > max1 || max2 < min1) // the projections don't overlap
-        {
-            collided = false;
-        }
     }
 
-    free(shapes);
+    arena_rewind(frame_arena(), mark);
     collision_info_t collision_info = (collision_info_t){.collided = collided,
                                                          .axis = collision_axis};
+    PROFILE_END(PROFILE_FIND_COLLISION);
+    return collision_info;
+}
+
+collision_info_t find_collision_points(const vector_t *shape1, size_t size1,
+                                       const vector_t *shape2, size_t size2)
+{
+    return find_separating_axis(shape1, size1, shape2, size2, get_projection_range_simd);
+}
+
+collision_info_t find_collision_points_scalar(const vector_t *shape1, size_t size1,
+                                              const vector_t *shape2, size_t size2)
+{
+    return find_separating_axis(shape1, size1, shape2, size2, get_projection_range);
+}
+
+collision_info_t find_polygon_collision(const polygon_t *shape1, const polygon_t *shape2)
+{
+    return find_collision_points(shape1->points, shape1->size, shape2->points, shape2->size);
+}
+
+collision_info_t find_collision(list_t *shape1, list_t *shape2)
+{
+    polygon_t *polygon1 = polygon_from_list(shape1);
+    polygon_t *polygon2 = polygon_from_list(shape2);
+    collision_info_t collision_info = find_polygon_collision(polygon1, polygon2);
+    polygon_free(polygon1);
+    polygon_free(polygon2);
     return collision_info;
 }
+
+collision_info_t find_circle_collision(vector_t center1, double radius1, vector_t center2, double radius2)
+{
+    vector_t difference = vec_subtract(center2, center1);
+    double distance = vec_magnitude(difference);
+    // concentric circles can be pushed apart in any direction
+    vector_t axis = distance > 0 ? vec_multiply(1 / distance, difference) : (vector_t){1, 0};
+    return (collision_info_t){.collided = distance <= radius1 + radius2, .axis = axis};
+}
+
+collision_info_t find_circle_aabb_collision(vector_t center, double radius,
+                                            vector_t box_center, vector_t half_extents)
+{
+    vector_t offset = vec_subtract(center, box_center);
+    vector_t closest = {.x = fmax(-half_extents.x, fmin(half_extents.x, offset.x)),
+                        .y = fmax(-half_extents.y, fmin(half_extents.y, offset.y))};
+    vector_t outside = vec_subtract(offset, closest);
+    double distance = vec_magnitude(outside);
+    if (distance > 0)
+    {
+        return (collision_info_t){.collided = distance <= radius,
+                                  .axis = vec_multiply(-1 / distance, outside)};
+    }
+
+    // the center is inside the box, so push it out through the nearest edge
+    double depth_x = half_extents.x - fabs(offset.x);
+    double depth_y = half_extents.y - fabs(offset.y);
+    vector_t axis = depth_x < depth_y ? (vector_t){offset.x < 0 ? 1 : -1, 0}
+                                      : (vector_t){0, offset.y < 0 ? 1 : -1};
+    return (collision_info_t){.collided = true, .axis = axis};
+}
+
+collision_info_t find_aabb_collision(vector_t center1, vector_t half_extents1,
+                                     vector_t center2, vector_t half_extents2)
+{
+    vector_t difference = vec_subtract(center2, center1);
+    double overlap_x = half_extents1.x + half_extents2.x - fabs(difference.x);
+    double overlap_y = half_extents1.y + half_extents2.y - fabs(difference.y);
+    vector_t axis = overlap_x < overlap_y ? (vector_t){difference.x < 0 ? -1 : 1, 0}
+                                          : (vector_t){0, difference.y < 0 ? -1 : 1};
+    return (collision_info_t){.collided = overlap_x >= 0 && overlap_y >= 0, .axis = axis};
+}
+
+collision_info_t find_body_collision(body_t *body1, body_t *body2)
+{
+    shape_kind_t kind1 = body_get_shape_kind(body1);
+    shape_kind_t kind2 = body_get_shape_kind(body2);
+    if (kind1 != SHAPE_POLYGON && kind2 != SHAPE_POLYGON)
+    {
+        PROFILE_COUNT(PROFILE_COLLISION_TESTS, 1);
+        vector_t center1 = body_get_centroid(body1);
+        vector_t center2 = body_get_centroid(body2);
+        if (kind1 == SHAPE_CIRCLE && kind2 == SHAPE_CIRCLE)
+        {
+            return find_circle_collision(center1, body_get_radius(body1), center2, body_get_radius(body2));
+        }
+        if (kind1 == SHAPE_AABB && kind2 == SHAPE_AABB)
+        {
+            return find_aabb_collision(center1, body_get_half_extents(body1),
+                                       center2, body_get_half_extents(body2));
+        }
+        if (kind1 == SHAPE_CIRCLE)
+        {
+            return find_circle_aabb_collision(center1, body_get_radius(body1),
+                                              center2, body_get_half_extents(body2));
+        }
+        collision_info_t collision = find_circle_aabb_collision(center2, body_get_radius(body2),
+                                                                center1, body_get_half_extents(body1));
+        collision.axis = vec_negate(collision.axis);
+        return collision;
+    }
+
+    size_t size1;
+    size_t size2;
+    const vector_t *shape1 = body_peek_shape(body1, &size1);
+    const vector_t *shape2 = body_peek_shape(body2, &size2);
+    return find_collision_points(shape1, size1, shape2, size2);
+}
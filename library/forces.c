@@ -1,6 +1,7 @@
 #include <math.h>
 #include "forces.h"
 #include "collision.h"
+#include "profile.h"
 
 const double DISTANCE_THRESHOLD = 5.0;
 
@@ -144,6 +145,7 @@ void collision_aux_free(collision_aux_t *c_aux)
 void collision_creator(collision_aux_t *c_aux)
 {
     assert(list_size(c_aux->bodies) == 2);
+    PROFILE_BEGIN(PROFILE_COLLISION_CREATOR);
     body_t *body1 = list_get(c_aux->bodies, 0);
     body_t *body2 = list_get(c_aux->bodies, 1);
 
@@ -151,10 +153,11 @@ void collision_creator(collision_aux_t *c_aux)
     // distance from centroid to vertex) to avoid extra math
     if (vec_distance(body_get_centroid(body1), body_get_centroid(body2)) > body_get_size(body1) + body_get_size(body2))
     {
+        PROFILE_END(PROFILE_COLLISION_CREATOR);
         return;
     }
 
-    collision_info_t collision = find_collision(body_get_shape(body1), body_get_shape(body2));
+    collision_info_t collision = find_body_collision(body1, body2);
     bool currently_colliding = collision.collided;
     vector_t collision_axis = collision.axis;
 
@@ -171,6 +174,7 @@ void collision_creator(collision_aux_t *c_aux)
         // not colliding
         c_aux->has_collided = false;
     }
+    PROFILE_END(PROFILE_COLLISION_CREATOR);
 }
 
 void create_collision(scene_t *scene, body_t *body1, body_t *body2, collision_handler_t handler, void *aux, free_func_t freer)
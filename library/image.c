@@ -1,20 +1,26 @@
 #include "image.h"
+#include "sdl_wrapper.h"
 
 image_t *image_init(char *image_filename, vector_t position, vector_t size, int image_type)
 {
     image_t *image = malloc(sizeof(image_t));
     *image = (image_t){.image_filename = image_filename, .position = position, 
-                        .size = size, .removed = false, .image_type = image_type};
+                        .size = size, .removed = false, .image_type = image_type,
+                        .texture = sdl_texture_acquire(image_filename, image_type)};
     return image;
 }
 
 void image_set(image_t *image, char *new_image_name)
 {
     strcpy(image->image_filename, new_image_name);
+    texture_t *texture = sdl_texture_acquire(new_image_name, image->image_type);
+    sdl_texture_release(image->texture);
+    image->texture = texture;
 }
 
 void image_free(image_t *image)
 {
+    sdl_texture_release(image->texture);
     free(image);
 }
 
@@ -66,6 +66,29 @@ void *list_remove(list_t *list, size_t index)
     return removed;
 }
 
+size_t list_remove_if(list_t *list, list_predicate_t should_remove)
+{
+    size_t kept = 0;
+    for (size_t i = 0; i < list->size; i++)
+    {
+        void *value = list->array[i];
+        if (should_remove(value))
+        {
+            if (list->freer != NULL)
+            {
+                list->freer(value);
+            }
+        }
+        else
+        {
+            list->array[kept++] = value;
+        }
+    }
+    size_t removed = list->size - kept;
+    list->size = kept;
+    return removed;
+}
+
 void list_resize(list_t *list)
 {
     if (list->size >= list->capacity)
@@ -6,37 +6,157 @@ const double PATH_WIDTH = 20;
 const int PATH_EDGE_MIN = 0;
 const int PATH_EDGE_MAX = 800; // value based on shop
 const rgb_color_t PATH_COLOR = {.r = (float)0.9, .g = (float)0.91, .b = (float)0.83};
-const double NODE_RADIUS = 3.0;
-const size_t NODE_POINTS = 4;
 
-body_t *create_path(scene_t *scene, list_t *vertices, list_t *directions)
+typedef struct path
 {
-    // overall path
-    body_t *path_body = body_init_with_secondary_info(vertices, PATH_MASS, PATH_COLOR, NULL, NULL, PATH_TYPE);
-    scene_add_body(scene, path_body);
+    vector_t *points;
+    vector_t *directions; // unit vector along each segment, from points[i] to points[i + 1]
+    double *lengths;      // arc length from the start to each point
+    size_t num_points;
+} path_t;
 
-    // create path turn nodes, add collision is in create_virus()
-    for (size_t i = 0; i < list_size(vertices) / 2; i++)
+// PRIVATE HELPER FUNCTION DECLARATIONS
+size_t path_find_segment(path_t *path, double progress);
+void path_info_free(global_body_info_t *info);
+
+path_t *path_init(const vector_t *points, size_t num_points)
+{
+    path_t *path = malloc(sizeof(path_t));
+    assert(path != NULL);
+    path->points = malloc(num_points * sizeof(vector_t));
+    assert(path->points != NULL);
+    path->directions = malloc(num_points * sizeof(vector_t));
+    assert(path->directions != NULL);
+    path->lengths = malloc(num_points * sizeof(double));
+    assert(path->lengths != NULL);
+
+    path->num_points = 0;
+    for (size_t i = 0; i < num_points; i++)
+    {
+        if (path->num_points == 0)
+        {
+            path->points[0] = points[i];
+            path->lengths[0] = 0;
+            path->num_points = 1;
+            continue;
+        }
+        size_t last = path->num_points - 1;
+        vector_t segment = vec_subtract(points[i], path->points[last]);
+        double length = vec_magnitude(segment);
+        if (length == 0)
+        {
+            continue;
+        }
+        path->directions[last] = vec_multiply(1 / length, segment);
+        path->points[path->num_points] = points[i];
+        path->lengths[path->num_points] = path->lengths[last] + length;
+        path->num_points++;
+    }
+    assert(path->num_points >= 2);
+    return path;
+}
+
+void path_free(path_t *path)
+{
+    free(path->points);
+    free(path->directions);
+    free(path->lengths);
+    free(path);
+}
+
+void path_info_free(global_body_info_t *info)
+{
+    // the path body's info owns the compiled center line
+    path_free(info->secondary_info);
+    free(info);
+}
+
+double path_get_length(path_t *path)
+{
+    return path->lengths[path->num_points - 1];
+}
+
+size_t path_find_segment(path_t *path, double progress)
+{
+    // the last segment starting at or before the progress, or the first one if none do
+    size_t low = 0;
+    size_t high = path->num_points - 2;
+    while (low < high)
+    {
+        size_t mid = (low + high + 1) / 2;
+        if (path->lengths[mid] <= progress)
+        {
+            low = mid;
+        }
+        else
+        {
+            high = mid - 1;
+        }
+    }
+    return low;
+}
+
+vector_t path_get_position(path_t *path, double progress)
+{
+    size_t segment = path_find_segment(path, progress);
+    return vec_add(path->points[segment],
+                   vec_multiply(progress - path->lengths[segment], path->directions[segment]));
+}
+
+vector_t path_get_direction(path_t *path, double progress)
+{
+    return path->directions[path_find_segment(path, progress)];
+}
+
+double path_get_progress(path_t *path, vector_t position)
+{
+    double closest_progress = 0;
+    double closest_distance = INFINITY;
+    for (size_t i = 0; i + 1 < path->num_points; i++)
+    {
+        // only the first and last segments extend past their points
+        double along = vec_dot(vec_subtract(position, path->points[i]), path->directions[i]);
+        if (i > 0)
+        {
+            along = fmax(along, 0);
+        }
+        if (i + 2 < path->num_points)
+        {
+            along = fmin(along, path->lengths[i + 1] - path->lengths[i]);
+        }
+        vector_t closest = vec_add(path->points[i], vec_multiply(along, path->directions[i]));
+        double distance = vec_magnitude(vec_subtract(position, closest));
+        if (distance < closest_distance)
+        {
+            closest_distance = distance;
+            closest_progress = path->lengths[i] + along;
+        }
+    }
+    return closest_progress;
+}
+
+body_t *create_path(scene_t *scene, list_t *vertices)
+{
+    // the center line runs between each outer vertex and the matching inner one
+    size_t num_vertices = list_size(vertices);
+    vector_t *center = malloc(num_vertices / 2 * sizeof(vector_t));
+    assert(center != NULL);
+    for (size_t i = 0; i < num_vertices / 2; i++)
     {
-        // inner always bigger than outer
-        vector_t v1 = *((vector_t *)list_get(vertices, i));                           // outer
-        vector_t v2 = *((vector_t *)list_get(vertices, list_size(vertices) - 1 - i)); // inner
-        vector_t midpoint = vec_midpoint(v1, v2);                                     // midpoint
-
-        turn_direction_t *dir_tmp = ((turn_direction_t *)list_get(directions, i));
-        turn_direction_t *dir_info = malloc(sizeof(turn_direction_t));
-        dir_info->dir = dir_tmp->dir;
-        dir_info->num = (int)i;
-
-        list_t *node_circle = polygon_make_circle(midpoint, NODE_RADIUS, NODE_POINTS);
-        body_t *node = body_init_with_secondary_info(node_circle, PATH_MASS, PATH_COLOR, dir_info, free, PATH_TURN_NODE_TYPE);
-        scene_add_body(scene, node);
+        vector_t *outer = list_get(vertices, i);
+        vector_t *inner = list_get(vertices, num_vertices - 1 - i);
+        center[i] = vec_midpoint(*outer, *inner);
     }
+    path_t *path = path_init(center, num_vertices / 2);
+    free(center);
 
+    body_t *path_body = body_init_with_secondary_info(vertices, PATH_MASS, PATH_COLOR, path,
+                                                      (free_func_t)path_info_free, PATH_TYPE);
+    scene_add_static_body(scene, path_body);
     return path_body;
 }
 
-void draw_simple_path(scene_t *scene, double demo_window_height)
+path_t *draw_simple_path(scene_t *scene, double demo_window_height)
 {
     list_t *path_vertices = list_init(8, free);
 
@@ -52,22 +172,10 @@ void draw_simple_path(scene_t *scene, double demo_window_height)
     list_add(path_vertices, vec_init(PATH_EDGE_MAX - PATH_WIDTH * 3, demo_window_height - 5 * PATH_WIDTH));
     list_add(path_vertices, vec_init(PATH_EDGE_MIN, demo_window_height - 5 * PATH_WIDTH));
 
-    list_t *directions = list_init(4, free);
-    turn_direction_t *l = malloc(sizeof(turn_direction_t));
-    l->dir = LEFT_TURN;
-    turn_direction_t *r = malloc(sizeof(turn_direction_t));
-    r->dir = RIGHT_TURN;
-    turn_direction_t *n = malloc(sizeof(turn_direction_t));
-    n->dir = NO_TURN;
-    list_add(directions, n);
-    list_add(directions, r);
-    list_add(directions, r);
-    list_add(directions, n);
-
-    create_path(scene, path_vertices, directions);
+    return get_global_secondary_info(create_path(scene, path_vertices));
 }
 
-void draw_medium_path(scene_t *scene, double demo_window_height)
+path_t *draw_medium_path(scene_t *scene, double demo_window_height)
 {
     list_t *path_vertices = list_init(16, free);
 
@@ -91,26 +199,10 @@ void draw_medium_path(scene_t *scene, double demo_window_height)
     list_add(path_vertices, vec_init(PATH_EDGE_MAX - PATH_WIDTH * 3, demo_window_height - 5 * PATH_WIDTH));
     list_add(path_vertices, vec_init(PATH_EDGE_MIN, demo_window_height - 5 * PATH_WIDTH));
 
-    list_t *directions = list_init(8, free);
-    turn_direction_t *l = malloc(sizeof(turn_direction_t));
-    l->dir = LEFT_TURN;
-    turn_direction_t *r = malloc(sizeof(turn_direction_t));
-    r->dir = RIGHT_TURN;
-    turn_direction_t *n = malloc(sizeof(turn_direction_t));
-    n->dir = NO_TURN;
-    list_add(directions, n);
-    list_add(directions, r);
-    list_add(directions, r);
-    list_add(directions, l);
-    list_add(directions, l);
-    list_add(directions, r);
-    list_add(directions, r);
-    list_add(directions, n);
-
-    create_path(scene, path_vertices, directions);
+    return get_global_secondary_info(create_path(scene, path_vertices));
 }
 
-void draw_complex_path(scene_t *scene, double demo_window_height)
+path_t *draw_complex_path(scene_t *scene, double demo_window_height)
 {
     list_t *path_vertices = list_init(24, free);
 
@@ -142,25 +234,5 @@ void draw_complex_path(scene_t *scene, double demo_window_height)
     list_add(path_vertices, vec_init(PATH_EDGE_MAX / 3 - PATH_WIDTH, demo_window_height - 5 * PATH_WIDTH));
     list_add(path_vertices, vec_init(PATH_EDGE_MIN, demo_window_height - 5 * PATH_WIDTH));
 
-    list_t *directions = list_init(12, free);
-    turn_direction_t *l = malloc(sizeof(turn_direction_t));
-    l->dir = LEFT_TURN;
-    turn_direction_t *r = malloc(sizeof(turn_direction_t));
-    r->dir = RIGHT_TURN;
-    turn_direction_t *n = malloc(sizeof(turn_direction_t));
-    n->dir = NO_TURN;
-    list_add(directions, n);
-    list_add(directions, r);
-    list_add(directions, l);
-    list_add(directions, l);
-    list_add(directions, r);
-    list_add(directions, r);
-    list_add(directions, r);
-    list_add(directions, l);
-    list_add(directions, l);
-    list_add(directions, r);
-    list_add(directions, r);
-    list_add(directions, n);
-
-    create_path(scene, path_vertices, directions);
+    return get_global_secondary_info(create_path(scene, path_vertices));
 }
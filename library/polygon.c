@@ -1,66 +1,129 @@
 #include "polygon.h"
 
-double polygon_area(list_t *polygon)
+// PRIVATE HELPER FUNCTION DECLARATIONS
+void polygon_copy_to_list(const polygon_t *polygon, list_t *list);
+
+polygon_t *polygon_init(const vector_t *points, size_t size)
+{
+    polygon_t *polygon = malloc(sizeof(polygon_t));
+    assert(polygon != NULL);
+    polygon->points = malloc(size * sizeof(vector_t));
+    assert(polygon->points != NULL);
+    for (size_t i = 0; i < size; i++)
+    {
+        polygon->points[i] = points[i];
+    }
+    polygon->size = size;
+    return polygon;
+}
+
+polygon_t *polygon_from_list(list_t *polygon)
+{
+    polygon_t *packed = malloc(sizeof(polygon_t));
+    assert(packed != NULL);
+    packed->size = list_size(polygon);
+    packed->points = malloc(packed->size * sizeof(vector_t));
+    assert(packed->points != NULL);
+    for (size_t i = 0; i < packed->size; i++)
+    {
+        packed->points[i] = *(vector_t *)list_get(polygon, i);
+    }
+    return packed;
+}
+
+list_t *polygon_to_list(const polygon_t *polygon)
 {
+    list_t *list = list_init(polygon->size, free);
+    for (size_t i = 0; i < polygon->size; i++)
+    {
+        vector_t *point = malloc(sizeof(vector_t));
+        assert(point != NULL);
+        *point = polygon->points[i];
+        list_add(list, point);
+    }
+    return list;
+}
+
+void polygon_copy_to_list(const polygon_t *polygon, list_t *list)
+{
+    for (size_t i = 0; i < polygon->size; i++)
+    {
+        *(vector_t *)list_get(list, i) = polygon->points[i];
+    }
+}
+
+void polygon_free(polygon_t *polygon)
+{
+    free(polygon->points);
+    free(polygon);
+}
+
+double polygon_packed_area(const polygon_t *polygon)
+{
+    const vector_t *points = polygon->points;
     double sum = 0.0;
-    size_t prev_i = list_size(polygon) - 1;
-    for (size_t i = 0; i < list_size(polygon); i++)
+    size_t prev_i = polygon->size - 1;
+    for (size_t i = 0; i < polygon->size; i++)
     {
-        sum += vec_cross((*(vector_t *)list_get(polygon, prev_i)), *(vector_t *)list_get(polygon, i));
+        sum += vec_cross(points[prev_i], points[i]);
         prev_i = i;
     }
     return 0.5 * sum;
 }
 
-vector_t polygon_centroid(list_t *polygon)
+vector_t polygon_packed_centroid(const polygon_t *polygon)
 {
+    const vector_t *points = polygon->points;
     double x_sum = 0.0;
     double y_sum = 0.0;
-    size_t prev_i = list_size(polygon) - 1;
+    size_t prev_i = polygon->size - 1;
 
-    for (size_t i = 0; i < list_size(polygon); i++)
+    for (size_t i = 0; i < polygon->size; i++)
     {
-        vector_t v1 = *(vector_t *)list_get(polygon, prev_i);
-        vector_t v2 = *(vector_t *)list_get(polygon, i);
+        vector_t v1 = points[prev_i];
+        vector_t v2 = points[i];
         double det = vec_cross(v1, v2);
         x_sum += (v1.x + v2.x) * det;
         y_sum += (v1.y + v2.y) * det;
         prev_i = i;
     }
 
-    double sixth_area = 1 / (polygon_area(polygon) * 6);
+    double sixth_area = 1 / (polygon_packed_area(polygon) * 6);
     return (vector_t){.x = sixth_area * x_sum, .y = sixth_area * y_sum};
 }
 
-void polygon_translate(list_t *polygon, vector_t translation)
+void polygon_packed_translate(polygon_t *polygon, vector_t translation)
 {
-    for (size_t i = 0; i < list_size(polygon); i++)
+    vector_t *points = polygon->points;
+    size_t size = polygon->size;
+    for (size_t i = 0; i < size; i++)
     {
-        vector_t v_tmp = vec_add(*(vector_t *)list_get(polygon, i), translation);
-        ((vector_t *)list_get(polygon, i))->x = v_tmp.x;
-        ((vector_t *)list_get(polygon, i))->y = v_tmp.y;
+        points[i].x += translation.x;
+        points[i].y += translation.y;
     }
 }
 
-void polygon_rotate(list_t *polygon, double angle, vector_t point)
+void polygon_packed_rotate(polygon_t *polygon, double angle, vector_t point)
 {
-    polygon_translate(polygon, vec_negate(point));
-    for (size_t i = 0; i < list_size(polygon); i++)
+    vector_t *points = polygon->points;
+    double cos_angle = cos(angle);
+    double sin_angle = sin(angle);
+    for (size_t i = 0; i < polygon->size; i++)
     {
-        vector_t v_tmp = vec_rotate(*(vector_t *)list_get(polygon, i), angle);
-        ((vector_t *)list_get(polygon, i))->x = v_tmp.x;
-        ((vector_t *)list_get(polygon, i))->y = v_tmp.y;
+        double x = points[i].x - point.x;
+        double y = points[i].y - point.y;
+        points[i].x = x * cos_angle - y * sin_angle + point.x;
+        points[i].y = x * sin_angle + y * cos_angle + point.y;
     }
-    polygon_translate(polygon, point);
 }
 
-double polygon_max_distance_across(list_t *polygon)
+double polygon_packed_max_distance_across(const polygon_t *polygon)
 {
     double max = 0.0;
-    vector_t c = polygon_centroid(polygon);
-    for (size_t i = 0; i < list_size(polygon); i++)
+    vector_t c = polygon_packed_centroid(polygon);
+    for (size_t i = 0; i < polygon->size; i++)
     {
-        double curr_dist = vec_distance(*(vector_t *)list_get(polygon, i), c);
+        double curr_dist = vec_distance(polygon->points[i], c);
         if (curr_dist > max)
         {
             max = curr_dist;
@@ -69,13 +132,13 @@ double polygon_max_distance_across(list_t *polygon)
     return max;
 }
 
-double polygon_min_distance_across(list_t *polygon)
+double polygon_packed_min_distance_across(const polygon_t *polygon)
 {
     double min = INFINITY;
-    vector_t c = polygon_centroid(polygon);
-    for (size_t i = 0; i < list_size(polygon); i++)
+    vector_t c = polygon_packed_centroid(polygon);
+    for (size_t i = 0; i < polygon->size; i++)
     {
-        double curr_dist = vec_distance(*(vector_t *)list_get(polygon, i), c);
+        double curr_dist = vec_distance(polygon->points[i], c);
         if (curr_dist < min)
         {
             min = curr_dist;
@@ -84,6 +147,54 @@ double polygon_min_distance_across(list_t *polygon)
     return min;
 }
 
+double polygon_area(list_t *polygon)
+{
+    polygon_t *packed = polygon_from_list(polygon);
+    double area = polygon_packed_area(packed);
+    polygon_free(packed);
+    return area;
+}
+
+vector_t polygon_centroid(list_t *polygon)
+{
+    polygon_t *packed = polygon_from_list(polygon);
+    vector_t centroid = polygon_packed_centroid(packed);
+    polygon_free(packed);
+    return centroid;
+}
+
+void polygon_translate(list_t *polygon, vector_t translation)
+{
+    polygon_t *packed = polygon_from_list(polygon);
+    polygon_packed_translate(packed, translation);
+    polygon_copy_to_list(packed, polygon);
+    polygon_free(packed);
+}
+
+void polygon_rotate(list_t *polygon, double angle, vector_t point)
+{
+    polygon_t *packed = polygon_from_list(polygon);
+    polygon_packed_rotate(packed, angle, point);
+    polygon_copy_to_list(packed, polygon);
+    polygon_free(packed);
+}
+
+double polygon_max_distance_across(list_t *polygon)
+{
+    polygon_t *packed = polygon_from_list(polygon);
+    double max = polygon_packed_max_distance_across(packed);
+    polygon_free(packed);
+    return max;
+}
+
+double polygon_min_distance_across(list_t *polygon)
+{
+    polygon_t *packed = polygon_from_list(polygon);
+    double min = polygon_packed_min_distance_across(packed);
+    polygon_free(packed);
+    return min;
+}
+
 list_t *polygon_make_circle(vector_t position, double radius, size_t num_points)
 {
     list_t *shape = list_init(num_points, free);
@@ -101,6 +212,17 @@ list_t *polygon_make_circle(vector_t position, double radius, size_t num_points)
     return shape;
 }
 
+void polygon_fill_circle(vector_t *points, vector_t position, double radius, size_t num_points)
+{
+    // the angle is summed the same way as in polygon_make_circle(), so the vertices match exactly
+    double angle = 0;
+    for (size_t i = 0; i < num_points; i++)
+    {
+        points[i] = (vector_t){.x = position.x + radius * cos(angle), .y = position.y + radius * sin(angle)};
+        angle += 2 * M_PI / num_points;
+    }
+}
+
 list_t *polygon_make_rectangle(double x1, double y1, double x2, double y2)
 {
     list_t *shape = list_init(4, free);
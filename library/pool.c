@@ -0,0 +1,125 @@
+#include <stddef.h>
+#include "list.h"
+#include "pool.h"
+
+const size_t POOL_ALIGNMENT = sizeof(max_align_t);
+
+// every object is preceded by this header, so pool_release() can find the pool
+typedef struct pool_slot
+{
+    pool_t *pool;
+    struct pool_slot *next_free; // only used while the slot is on the free list
+} pool_slot_t;
+
+typedef struct pool
+{
+    size_t slot_size;   // header and object, rounded up to keep every object aligned
+    size_t header_size; // offset of the object within its slot
+    size_t objects_per_block;
+    list_t *blocks;
+    size_t block_index;   // block that unused slots are taken from
+    size_t used_in_block; // slots already taken from blocks[block_index]
+    pool_slot_t *free_head;
+    size_t live;
+} pool_t;
+
+// PRIVATE HELPER FUNCTION DECLARATIONS
+size_t pool_round_up(size_t size);
+pool_slot_t *pool_take_unused_slot(pool_t *pool);
+
+size_t pool_round_up(size_t size)
+{
+    return (size + POOL_ALIGNMENT - 1) / POOL_ALIGNMENT * POOL_ALIGNMENT;
+}
+
+pool_t *pool_init(size_t object_size, size_t objects_per_block)
+{
+    assert(object_size > 0);
+    assert(objects_per_block > 0);
+    pool_t *pool = malloc(sizeof(pool_t));
+    assert(pool != NULL);
+    pool->header_size = pool_round_up(sizeof(pool_slot_t));
+    pool->slot_size = pool->header_size + pool_round_up(object_size);
+    pool->objects_per_block = objects_per_block;
+    pool->blocks = list_init(1, free);
+    pool->block_index = 0;
+    pool->used_in_block = 0;
+    pool->free_head = NULL;
+    pool->live = 0;
+    return pool;
+}
+
+void pool_free(pool_t *pool)
+{
+    list_free(pool->blocks);
+    free(pool);
+}
+
+// takes the next slot that has never been handed out since the last rewind
+pool_slot_t *pool_take_unused_slot(pool_t *pool)
+{
+    if (pool->block_index < list_size(pool->blocks) && pool->used_in_block == pool->objects_per_block)
+    {
+        pool->block_index++;
+        pool->used_in_block = 0;
+    }
+    if (pool->block_index == list_size(pool->blocks))
+    {
+        char *block = malloc(pool->slot_size * pool->objects_per_block);
+        assert(block != NULL);
+        list_add(pool->blocks, block);
+    }
+    char *block = list_get(pool->blocks, pool->block_index);
+    return (pool_slot_t *)(block + pool->slot_size * pool->used_in_block++);
+}
+
+void *pool_alloc(pool_t *pool)
+{
+    pool_slot_t *slot = pool->free_head;
+    if (slot != NULL)
+    {
+        pool->free_head = slot->next_free;
+    }
+    else
+    {
+        slot = pool_take_unused_slot(pool);
+    }
+    slot->pool = pool;
+    slot->next_free = NULL;
+    pool->live++;
+    return (char *)slot + pool->header_size;
+}
+
+void pool_release(void *object)
+{
+    if (object == NULL)
+    {
+        return;
+    }
+    // the header size is the same for every pool
+    pool_slot_t *slot = (pool_slot_t *)((char *)object - pool_round_up(sizeof(pool_slot_t)));
+    pool_t *pool = slot->pool;
+    assert(pool != NULL); // NULL if the object was already released
+    slot->pool = NULL;
+    pool->live--;
+    if (pool->live == 0)
+    {
+        // nothing is in use, so forget the free list and hand out slots in order again
+        pool->free_head = NULL;
+        pool->block_index = 0;
+        pool->used_in_block = 0;
+        return;
+    }
+    slot->next_free = pool->free_head;
+    pool->free_head = slot;
+}
+
+size_t pool_live(pool_t *pool)
+{
+    return pool->live;
+}
+
+size_t pool_capacity(pool_t *pool)
+{
+    return list_size(pool->blocks) * pool->objects_per_block;
+}
@@ -0,0 +1,233 @@
+#include <string.h>
+#include <SDL2/SDL.h>
+#include "profile.h"
+
+const size_t PROFILE_MAX_FRAMES = 240;
+const size_t PROFILE_MAX_EVENTS = 1 << 16;
+const double PROFILE_US_PER_S = 1e6;
+const double PROFILE_MS_PER_S = 1e3;
+
+const char *PROFILE_ZONE_NAMES[NUM_PROFILE_ZONES] = {
+    "scene_tick",
+    "forces",
+    "collision_rules",
+    "integrate",
+    "remove_flags",
+    "collision_creator",
+    "find_collision",
+    "tower_tick",
+    "render",
+    "render_polygons",
+    "render_text",
+    "render_images",
+    "asset_load",
+};
+
+const char *PROFILE_COUNTER_NAMES[NUM_PROFILE_COUNTERS] = {
+    "bodies",
+    "collision_tests",
+    "draw_calls",
+    "texts_rasterized",
+};
+
+typedef struct profile_frame_sample
+{
+    Uint64 start;
+    Uint64 end;
+    Uint64 zone_ticks[NUM_PROFILE_ZONES];
+    size_t zone_calls[NUM_PROFILE_ZONES];
+    size_t counters[NUM_PROFILE_COUNTERS];
+} profile_frame_sample_t;
+
+typedef struct profile_event
+{
+    profile_zone_t zone;
+    Uint64 start;
+    Uint64 duration;
+} profile_event_t;
+
+typedef struct profiler
+{
+    profile_frame_sample_t *frames; // ring buffer of ended frames
+    size_t num_frames;              // frames ended so far, frames[num_frames % PROFILE_MAX_FRAMES] is next
+    profile_event_t *events;        // ring buffer of zone entries
+    size_t num_events;
+    profile_frame_sample_t current;
+    Uint64 zone_start[NUM_PROFILE_ZONES];
+} profiler_t;
+
+profiler_t profiler = {.frames = NULL};
+
+// PRIVATE HELPER FUNCTION DECLARATIONS
+void profiler_ensure_init(void);
+const profile_frame_sample_t *profile_last_frame(void);
+double profile_ticks_to_us(Uint64 ticks);
+
+void profiler_ensure_init(void)
+{
+    if (profiler.frames != NULL)
+    {
+        return;
+    }
+    profiler.frames = malloc(PROFILE_MAX_FRAMES * sizeof(profile_frame_sample_t));
+    assert(profiler.frames != NULL);
+    profiler.events = malloc(PROFILE_MAX_EVENTS * sizeof(profile_event_t));
+    assert(profiler.events != NULL);
+    profile_reset();
+}
+
+const profile_frame_sample_t *profile_last_frame(void)
+{
+    if (profiler.num_frames == 0)
+    {
+        return NULL;
+    }
+    return &profiler.frames[(profiler.num_frames - 1) % PROFILE_MAX_FRAMES];
+}
+
+double profile_ticks_to_us(Uint64 ticks)
+{
+    return (double)ticks * PROFILE_US_PER_S / SDL_GetPerformanceFrequency();
+}
+
+void profile_begin(profile_zone_t zone)
+{
+    assert(zone < NUM_PROFILE_ZONES);
+    profiler_ensure_init();
+    profiler.zone_start[zone] = SDL_GetPerformanceCounter();
+}
+
+void profile_end(profile_zone_t zone)
+{
+    assert(zone < NUM_PROFILE_ZONES);
+    profiler_ensure_init();
+    Uint64 start = profiler.zone_start[zone];
+    Uint64 duration = SDL_GetPerformanceCounter() - start;
+    profiler.current.zone_ticks[zone] += duration;
+    profiler.current.zone_calls[zone]++;
+
+    profile_event_t *event = &profiler.events[profiler.num_events % PROFILE_MAX_EVENTS];
+    *event = (profile_event_t){.zone = zone, .start = start, .duration = duration};
+    profiler.num_events++;
+}
+
+void profile_count(profile_counter_t counter, size_t amount)
+{
+    assert(counter < NUM_PROFILE_COUNTERS);
+    profiler_ensure_init();
+    profiler.current.counters[counter] += amount;
+}
+
+void profile_frame(void)
+{
+    profiler_ensure_init();
+    Uint64 now = SDL_GetPerformanceCounter();
+    profiler.current.end = now;
+    profiler.frames[profiler.num_frames % PROFILE_MAX_FRAMES] = profiler.current;
+    profiler.num_frames++;
+
+    memset(&profiler.current, 0, sizeof(profile_frame_sample_t));
+    profiler.current.start = now;
+}
+
+size_t profile_frames(void)
+{
+    return profiler.num_frames;
+}
+
+double profile_last_ms(profile_zone_t zone)
+{
+    assert(zone < NUM_PROFILE_ZONES);
+    const profile_frame_sample_t *frame = profile_last_frame();
+    if (frame == NULL)
+    {
+        return 0.0;
+    }
+    return (double)frame->zone_ticks[zone] * PROFILE_MS_PER_S / SDL_GetPerformanceFrequency();
+}
+
+size_t profile_last_calls(profile_zone_t zone)
+{
+    assert(zone < NUM_PROFILE_ZONES);
+    const profile_frame_sample_t *frame = profile_last_frame();
+    return frame == NULL ? 0 : frame->zone_calls[zone];
+}
+
+size_t profile_last_count(profile_counter_t counter)
+{
+    assert(counter < NUM_PROFILE_COUNTERS);
+    const profile_frame_sample_t *frame = profile_last_frame();
+    return frame == NULL ? 0 : frame->counters[counter];
+}
+
+const char *profile_zone_name(profile_zone_t zone)
+{
+    assert(zone < NUM_PROFILE_ZONES);
+    return PROFILE_ZONE_NAMES[zone];
+}
+
+void profile_format_zone(profile_zone_t zone, char *buffer, size_t size)
+{
+    snprintf(buffer, size, "%s %.2f ms (%zu)", profile_zone_name(zone),
+             profile_last_ms(zone), profile_last_calls(zone));
+}
+
+bool profile_write_trace(const char *filename)
+{
+    profiler_ensure_init();
+    FILE *file = fopen(filename, "w");
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    size_t first_frame = profiler.num_frames > PROFILE_MAX_FRAMES ? profiler.num_frames - PROFILE_MAX_FRAMES : 0;
+    size_t first_event = profiler.num_events > PROFILE_MAX_EVENTS ? profiler.num_events - PROFILE_MAX_EVENTS : 0;
+    // timestamps are relative to the oldest retained frame, so events from overwritten frames are dropped
+    Uint64 origin = profiler.num_frames > 0
+                        ? profiler.frames[first_frame % PROFILE_MAX_FRAMES].start
+                        : profiler.current.start;
+
+    fprintf(file, "{\"traceEvents\":[\n");
+    bool first = true;
+    for (size_t i = first_frame; i < profiler.num_frames; i++)
+    {
+        const profile_frame_sample_t *frame = &profiler.frames[i % PROFILE_MAX_FRAMES];
+        double ts = profile_ticks_to_us(frame->start - origin);
+        fprintf(file, "%s{\"name\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+                first ? "" : ",\n", ts, profile_ticks_to_us(frame->end - frame->start));
+        first = false;
+
+        fprintf(file, ",\n{\"name\":\"counters\",\"ph\":\"C\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"args\":{", ts);
+        for (size_t c = 0; c < NUM_PROFILE_COUNTERS; c++)
+        {
+            fprintf(file, "%s\"%s\":%zu", c == 0 ? "" : ",", PROFILE_COUNTER_NAMES[c], frame->counters[c]);
+        }
+        fprintf(file, "}}");
+    }
+    for (size_t i = first_event; i < profiler.num_events; i++)
+    {
+        const profile_event_t *event = &profiler.events[i % PROFILE_MAX_EVENTS];
+        if (event->start < origin)
+        {
+            continue;
+        }
+        fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+                first ? "" : ",\n", PROFILE_ZONE_NAMES[event->zone],
+                profile_ticks_to_us(event->start - origin), profile_ticks_to_us(event->duration));
+        first = false;
+    }
+    fprintf(file, "\n]}\n");
+
+    return fclose(file) == 0;
+}
+
+void profile_reset(void)
+{
+    profiler_ensure_init();
+    profiler.num_frames = 0;
+    profiler.num_events = 0;
+    memset(&profiler.current, 0, sizeof(profile_frame_sample_t));
+    memset(profiler.zone_start, 0, sizeof(profiler.zone_start));
+    profiler.current.start = SDL_GetPerformanceCounter();
+}
@@ -1,15 +1,42 @@
 #include "scene.h"
+#include "collision.h"
+#include "spatial_grid.h"
+#include "bvh.h"
+#include "profile.h"
+#include "arena.h"
 
 const size_t DEFAULT_NUM_BODIES = 10;
 const size_t DEFAULT_NUM_FORCE_CREATORS = 5;
+const size_t DEFAULT_NUM_COLLISION_RULES = 5;
+const size_t DEFAULT_NUM_STATIC_BODIES = 10;
+const size_t DEFAULT_NUM_BODY_TYPES = 8;
+const size_t INITIAL_CONTACT_CAPACITY = 64;
+const size_t INITIAL_FORCE_INDEX_CAPACITY = 64;
+const double COLLISION_CELL_SIZE = 50.0;
+
+typedef struct collision_rule
+{
+    int type1;
+    int type2;
+    collision_handler_t handler;
+    void *aux;
+    free_func_t freer;
+} collision_rule_t;
 
-typedef struct scene
+typedef struct contact
 {
-    list_t *bodies;
-    list_t *force_packages;
-    list_t *texts;
-    list_t *images;
-} scene_t;
+    collision_rule_t *rule;
+    body_t *body1;
+    body_t *body2;
+} contact_t;
+
+// open addressing hash set of the pairs that were touching during a tick
+typedef struct contact_set
+{
+    contact_t *contacts;
+    size_t capacity;
+    size_t size;
+} contact_set_t;
 
 typedef struct force_package
 {
@@ -17,8 +44,43 @@ typedef struct force_package
     void *aux;
     list_t *bodies;
     free_func_t freer;
+    bool removed; // one of the bodies was removed, so the package is freed this tick
 } force_package_t;
 
+// the force packages that reference a body
+typedef struct force_links
+{
+    body_t *body;
+    list_t *packages; // not owned, the scene frees the packages
+} force_links_t;
+
+// open addressing hash map from bodies to their force links, so removing a
+// body only visits the packages that reference it
+typedef struct force_index
+{
+    force_links_t *entries;
+    size_t capacity;
+    size_t size;
+} force_index_t;
+
+typedef struct scene
+{
+    list_t *bodies;
+    body_store_t *body_store;
+    list_t *force_packages;
+    force_index_t *force_index;
+    list_t *texts;
+    list_t *images;
+    list_t *collision_rules;
+    spatial_grid_t *collision_grid;
+    contact_set_t *previous_contacts;
+    contact_set_t *current_contacts;
+    list_t *static_bodies; // also in bodies, not owned
+    list_t *type_buckets;  // a list of the bodies of each type, also in bodies
+    bvh_t *static_bvh;
+    bool static_bvh_stale; // rebuilt at the next query
+} scene_t;
+
 void force_package_free(force_package_t *force_package)
 {
     if (force_package->freer != NULL)
@@ -32,23 +94,341 @@ void force_package_free(force_package_t *force_package)
     free(force_package);
 }
 
+// PRIVATE HELPER FUNCTION DECLARATIONS
+void collision_rule_free(collision_rule_t *rule);
+contact_set_t *contact_set_init(size_t capacity);
+void contact_set_free(contact_set_t *set);
+void contact_set_clear(contact_set_t *set);
+size_t contact_hash(contact_t contact);
+contact_t *contact_set_find(contact_set_t *set, contact_t contact);
+bool contact_set_contains(contact_set_t *set, contact_t contact);
+void contact_set_add(contact_set_t *set, contact_t contact);
+void contact_set_remove_bodies(contact_set_t *set);
+list_t *scene_get_bucket(scene_t *scene, int type);
+bool scene_has_collision_rule(scene_t *scene, int type);
+void scene_collide_pair(body_t *body1, body_t *body2, scene_t *scene);
+void scene_check_collision_rules(scene_t *scene);
+bool force_package_is_removed(force_package_t *force_package);
+force_index_t *force_index_init(size_t capacity);
+void force_index_free(force_index_t *index);
+size_t force_index_hash(body_t *body);
+force_links_t *force_index_find(force_index_t *index, body_t *body);
+void force_index_add(force_index_t *index, body_t *body, force_package_t *package);
+void force_index_delete(force_index_t *index, force_links_t *links);
+void force_index_unlink(force_index_t *index, body_t *body, force_package_t *package);
+size_t force_index_remove_body(force_index_t *index, body_t *body);
+
+void collision_rule_free(collision_rule_t *rule)
+{
+    if (rule->freer != NULL)
+    {
+        rule->freer(rule->aux);
+    }
+    free(rule);
+}
+
+contact_set_t *contact_set_init(size_t capacity)
+{
+    contact_set_t *set = malloc(sizeof(contact_set_t));
+    assert(set != NULL);
+    set->contacts = calloc(capacity, sizeof(contact_t));
+    assert(set->contacts != NULL);
+    set->capacity = capacity;
+    set->size = 0;
+    return set;
+}
+
+void contact_set_free(contact_set_t *set)
+{
+    free(set->contacts);
+    free(set);
+}
+
+void contact_set_clear(contact_set_t *set)
+{
+    if (set->size > 0)
+    {
+        memset(set->contacts, 0, set->capacity * sizeof(contact_t));
+        set->size = 0;
+    }
+}
+
+size_t contact_hash(contact_t contact)
+{
+    size_t hash = (size_t)contact.rule;
+    hash = hash * 31 + (size_t)contact.body1;
+    hash = hash * 31 + (size_t)contact.body2;
+    return hash ^ (hash >> 7);
+}
+
+// returns the slot holding the contact, or the empty slot where it would go
+contact_t *contact_set_find(contact_set_t *set, contact_t contact)
+{
+    size_t mask = set->capacity - 1;
+    size_t i = contact_hash(contact) & mask;
+    while (set->contacts[i].rule != NULL)
+    {
+        contact_t *slot = &set->contacts[i];
+        if (slot->rule == contact.rule && slot->body1 == contact.body1 &&
+            slot->body2 == contact.body2)
+        {
+            return slot;
+        }
+        i = (i + 1) & mask;
+    }
+    return &set->contacts[i];
+}
+
+bool contact_set_contains(contact_set_t *set, contact_t contact)
+{
+    return contact_set_find(set, contact)->rule != NULL;
+}
+
+void contact_set_add(contact_set_t *set, contact_t contact)
+{
+    if (2 * (set->size + 1) > set->capacity)
+    {
+        contact_t *old_contacts = set->contacts;
+        size_t old_capacity = set->capacity;
+        set->capacity *= 2;
+        set->contacts = calloc(set->capacity, sizeof(contact_t));
+        assert(set->contacts != NULL);
+        set->size = 0;
+        for (size_t i = 0; i < old_capacity; i++)
+        {
+            if (old_contacts[i].rule != NULL)
+            {
+                *contact_set_find(set, old_contacts[i]) = old_contacts[i];
+                set->size++;
+            }
+        }
+        free(old_contacts);
+    }
+
+    contact_t *slot = contact_set_find(set, contact);
+    if (slot->rule == NULL)
+    {
+        *slot = contact;
+        set->size++;
+    }
+}
+
+// drops every contact involving a body that is about to be freed
+void contact_set_remove_bodies(contact_set_t *set)
+{
+    if (set->size == 0)
+    {
+        return;
+    }
+    contact_t *old_contacts = set->contacts;
+    set->contacts = calloc(set->capacity, sizeof(contact_t));
+    assert(set->contacts != NULL);
+    set->size = 0;
+    for (size_t i = 0; i < set->capacity; i++)
+    {
+        contact_t contact = old_contacts[i];
+        if (contact.rule != NULL && !body_is_removed(contact.body1) &&
+            !body_is_removed(contact.body2))
+        {
+            *contact_set_find(set, contact) = contact;
+            set->size++;
+        }
+    }
+    free(old_contacts);
+}
+
+bool force_package_is_removed(force_package_t *force_package)
+{
+    return force_package->removed;
+}
+
+force_index_t *force_index_init(size_t capacity)
+{
+    force_index_t *index = malloc(sizeof(force_index_t));
+    assert(index != NULL);
+    index->entries = calloc(capacity, sizeof(force_links_t));
+    assert(index->entries != NULL);
+    index->capacity = capacity;
+    index->size = 0;
+    return index;
+}
+
+void force_index_free(force_index_t *index)
+{
+    for (size_t i = 0; i < index->capacity; i++)
+    {
+        if (index->entries[i].body != NULL)
+        {
+            list_free(index->entries[i].packages);
+        }
+    }
+    free(index->entries);
+    free(index);
+}
+
+size_t force_index_hash(body_t *body)
+{
+    // allocations are aligned, so the low bits of the address carry no information
+    size_t hash = (size_t)body;
+    return (hash >> 4) ^ (hash >> 12);
+}
+
+// returns the slot holding the body's links, or the empty slot where they would go
+force_links_t *force_index_find(force_index_t *index, body_t *body)
+{
+    size_t mask = index->capacity - 1;
+    size_t i = force_index_hash(body) & mask;
+    while (index->entries[i].body != NULL && index->entries[i].body != body)
+    {
+        i = (i + 1) & mask;
+    }
+    return &index->entries[i];
+}
+
+void force_index_add(force_index_t *index, body_t *body, force_package_t *package)
+{
+    if (2 * (index->size + 1) > index->capacity)
+    {
+        force_links_t *old_entries = index->entries;
+        size_t old_capacity = index->capacity;
+        index->capacity *= 2;
+        index->entries = calloc(index->capacity, sizeof(force_links_t));
+        assert(index->entries != NULL);
+        for (size_t i = 0; i < old_capacity; i++)
+        {
+            if (old_entries[i].body != NULL)
+            {
+                *force_index_find(index, old_entries[i].body) = old_entries[i];
+            }
+        }
+        free(old_entries);
+    }
+
+    force_links_t *links = force_index_find(index, body);
+    if (links->body == NULL)
+    {
+        *links = (force_links_t){.body = body, .packages = list_init(1, NULL)};
+        index->size++;
+    }
+    list_add(links->packages, package);
+}
+
+// backward shift deletion, so lookups never need tombstones
+void force_index_delete(force_index_t *index, force_links_t *links)
+{
+    list_free(links->packages);
+    index->size--;
+
+    size_t mask = index->capacity - 1;
+    size_t hole = links - index->entries;
+    size_t i = hole;
+    while (true)
+    {
+        i = (i + 1) & mask;
+        force_links_t entry = index->entries[i];
+        if (entry.body == NULL)
+        {
+            break;
+        }
+        // an entry can fill the hole unless its home slot lies cyclically in (hole, i]
+        size_t home = force_index_hash(entry.body) & mask;
+        bool stays = hole <= i ? (hole < home && home <= i) : (hole < home || home <= i);
+        if (!stays)
+        {
+            index->entries[hole] = entry;
+            hole = i;
+        }
+    }
+    index->entries[hole] = (force_links_t){.body = NULL, .packages = NULL};
+}
+
+void force_index_unlink(force_index_t *index, body_t *body, force_package_t *package)
+{
+    force_links_t *links = force_index_find(index, body);
+    if (links->body == NULL)
+    {
+        return;
+    }
+    for (size_t i = 0; i < list_size(links->packages); i++)
+    {
+        if (list_get(links->packages, i) == package)
+        {
+            list_remove(links->packages, i);
+            break;
+        }
+    }
+}
+
+// marks every package that references the body as removed and forgets the body,
+// returning the number of packages newly marked
+size_t force_index_remove_body(force_index_t *index, body_t *body)
+{
+    force_links_t *links = force_index_find(index, body);
+    if (links->body == NULL)
+    {
+        return 0;
+    }
+    list_t *packages = links->packages;
+    size_t removed = 0;
+    for (size_t i = 0; i < list_size(packages); i++)
+    {
+        force_package_t *package = list_get(packages, i);
+        if (package->removed)
+        {
+            continue;
+        }
+        package->removed = true;
+        removed++;
+        // the package's other bodies must not reach it once it is freed
+        for (size_t j = 0; j < list_size(package->bodies); j++)
+        {
+            body_t *other = list_get(package->bodies, j);
+            if (other != body)
+            {
+                force_index_unlink(index, other, package);
+            }
+        }
+    }
+    force_index_delete(index, links);
+    return removed;
+}
+
 scene_t *scene_init(void)
 {
     scene_t *s = malloc(sizeof(scene_t));
     assert(s != NULL);
     s->bodies = list_init(DEFAULT_NUM_BODIES, (free_func_t)body_free);
+    s->body_store = body_store_init();
     s->force_packages = list_init(DEFAULT_NUM_FORCE_CREATORS, (free_func_t)force_package_free);
+    s->force_index = force_index_init(INITIAL_FORCE_INDEX_CAPACITY);
     s->texts = list_init(DEFAULT_NUM_BODIES, (free_func_t)text_free);
     s->images = list_init(DEFAULT_NUM_BODIES, (free_func_t)image_free);
+    s->collision_rules = list_init(DEFAULT_NUM_COLLISION_RULES, (free_func_t)collision_rule_free);
+    s->collision_grid = spatial_grid_init(COLLISION_CELL_SIZE);
+    s->previous_contacts = contact_set_init(INITIAL_CONTACT_CAPACITY);
+    s->current_contacts = contact_set_init(INITIAL_CONTACT_CAPACITY);
+    s->static_bodies = list_init(DEFAULT_NUM_STATIC_BODIES, NULL);
+    s->type_buckets = list_init(DEFAULT_NUM_BODY_TYPES, (free_func_t)list_free);
+    s->static_bvh = bvh_init();
+    s->static_bvh_stale = false;
     return s;
 }
 
 void scene_free(scene_t *scene)
 {
     list_free(scene->bodies);
+    body_store_free(scene->body_store);
     list_free(scene->force_packages);
+    force_index_free(scene->force_index);
     list_free(scene->texts);
     list_free(scene->images);
+    list_free(scene->collision_rules);
+    spatial_grid_free(scene->collision_grid);
+    contact_set_free(scene->previous_contacts);
+    contact_set_free(scene->current_contacts);
+    list_free(scene->static_bodies);
+    list_free(scene->type_buckets);
+    bvh_free(scene->static_bvh);
     free(scene);
 }
 
@@ -69,9 +449,26 @@ body_t *scene_get_body(scene_t *scene, size_t index)
     return list_get(scene->bodies, index);
 }
 
+list_t *scene_get_bucket(scene_t *scene, int type)
+{
+    assert(type >= 0);
+    while (list_size(scene->type_buckets) <= (size_t)type)
+    {
+        list_add(scene->type_buckets, list_init(DEFAULT_NUM_BODIES, NULL));
+    }
+    return list_get(scene->type_buckets, type);
+}
+
+list_t *scene_get_bodies_of_type(scene_t *scene, int type)
+{
+    return scene_get_bucket(scene, type);
+}
+
 void scene_add_body(scene_t *scene, body_t *body)
 {
     list_add(scene->bodies, body);
+    list_add(scene_get_bucket(scene, body_get_type(body)), body);
+    body_store_add(scene->body_store, body);
     image_t *image = body_get_image(body);
     text_t *label = body_get_label(body);
     if (image)
@@ -84,6 +481,50 @@ void scene_add_body(scene_t *scene, body_t *body)
     }
 }
 
+void scene_add_static_body(scene_t *scene, body_t *body)
+{
+    scene_add_body(scene, body);
+    list_add(scene->static_bodies, body);
+    scene->static_bvh_stale = true;
+}
+
+void scene_static_bodies_moved(scene_t *scene)
+{
+    scene->static_bvh_stale = true;
+}
+
+void scene_static_body_moved(scene_t *scene, body_t *body)
+{
+    // a stale tree picks up the new position when it is rebuilt anyway
+    if (!scene->static_bvh_stale && !bvh_refit(scene->static_bvh, body))
+    {
+        scene->static_bvh_stale = true;
+    }
+}
+
+void scene_query_static(scene_t *scene, vector_t center, double radius, list_t *results)
+{
+    if (scene->static_bvh_stale)
+    {
+        bvh_build(scene->static_bvh, scene->static_bodies);
+        scene->static_bvh_stale = false;
+    }
+    size_t start = list_size(results);
+    bvh_query_circle(scene->static_bvh, center, radius, results);
+    // bodies removed since the last tick are still in the tree
+    for (size_t i = start; i < list_size(results);)
+    {
+        if (body_is_removed(list_get(results, i)))
+        {
+            list_remove(results, i);
+        }
+        else
+        {
+            i++;
+        }
+    }
+}
+
 // DEPRECATED
 void scene_remove_body(scene_t *scene, size_t index)
 {
@@ -108,8 +549,16 @@ void scene_add_bodies_force_creator(scene_t *scene, force_creator_t forcer,
     {
         force_bodies = bodies;
     }
-    *force = (force_package_t){.forcer = forcer, .aux = aux, .freer = freer, .bodies = force_bodies};
+    *force = (force_package_t){.forcer = forcer, .aux = aux, .freer = freer, .bodies = force_bodies,
+                               .removed = false};
     list_add(scene->force_packages, force);
+    if (force_bodies != NULL)
+    {
+        for (size_t i = 0; i < list_size(force_bodies); i++)
+        {
+            force_index_add(scene->force_index, list_get(force_bodies, i), force);
+        }
+    }
 }
 
 // DEPRECATED
@@ -119,86 +568,183 @@ void scene_add_force_creator(scene_t *scene, force_creator_t forcer, void *aux,
     scene_add_bodies_force_creator(scene, forcer, aux, NULL, freer);
 }
 
-void scene_check_remove_flags(scene_t *scene)
+void scene_add_collision_rule(scene_t *scene, int type1, int type2,
+                              collision_handler_t handler, void *aux, free_func_t freer)
 {
-    size_t fp_index = 0;
-    while (fp_index < (list_size(scene->force_packages)))
+    for (size_t i = 0; i < list_size(scene->collision_rules); i++)
     {
-        force_package_t *fp = list_get(scene->force_packages, fp_index);
-        list_t *bodies = fp->bodies;
-
-        if (bodies != NULL)
+        collision_rule_t *rule = list_get(scene->collision_rules, i);
+        if (rule->type1 == type1 && rule->type2 == type2 && rule->handler == handler)
         {
-            for (size_t j = 0; j < list_size(bodies); j++)
+            // already registered, keep the existing rule and its aux
+            if (freer != NULL)
             {
-                if (body_is_removed(list_get(bodies, j)))
-                {
-                    force_package_free(list_remove(scene->force_packages, fp_index));
-                    fp_index--;
-                    break;
-                }
+                freer(aux);
             }
+            return;
         }
-        fp_index++;
     }
+    collision_rule_t *rule = malloc(sizeof(collision_rule_t));
+    assert(rule != NULL);
+    *rule = (collision_rule_t){.type1 = type1, .type2 = type2, .handler = handler,
+                               .aux = aux, .freer = freer};
+    list_add(scene->collision_rules, rule);
+}
 
-    size_t body_index = 0;
-    while (body_index < scene_bodies(scene))
+bool scene_has_collision_rule(scene_t *scene, int type)
+{
+    for (size_t i = 0; i < list_size(scene->collision_rules); i++)
     {
-        body_t *body = scene_get_body(scene, body_index);
-        if (body_is_removed(body))
+        collision_rule_t *rule = list_get(scene->collision_rules, i);
+        if (rule->type1 == type || rule->type2 == type)
         {
-            body_free(list_remove(scene->bodies, body_index));
+            return true;
+        }
+    }
+    return false;
+}
+
+void scene_collide_pair(body_t *body1, body_t *body2, scene_t *scene)
+{
+    int type1 = body_get_type(body1);
+    int type2 = body_get_type(body2);
+    for (size_t i = 0; i < list_size(scene->collision_rules); i++)
+    {
+        collision_rule_t *rule = list_get(scene->collision_rules, i);
+        body_t *first;
+        body_t *second;
+        if (rule->type1 == type1 && rule->type2 == type2)
+        {
+            first = body1;
+            second = body2;
+        }
+        else if (rule->type1 == type2 && rule->type2 == type1)
+        {
+            first = body2;
+            second = body1;
         }
         else
         {
-            body_index++;
+            continue;
+        }
+
+        if (vec_distance(body_get_centroid(first), body_get_centroid(second)) >
+            body_get_size(first) + body_get_size(second))
+        {
+            continue;
+        }
+
+        collision_info_t collision = find_body_collision(first, second);
+        if (!collision.collided)
+        {
+            continue;
+        }
+
+        contact_t contact = {.rule = rule, .body1 = first, .body2 = second};
+        contact_set_add(scene->current_contacts, contact);
+        if (!contact_set_contains(scene->previous_contacts, contact))
+        {
+            rule->handler(first, second, collision.axis, rule->aux);
         }
     }
+}
 
-    int text_index = 0;
-    while (text_index < scene_texts(scene))
+void scene_check_collision_rules(scene_t *scene)
+{
+    if (list_size(scene->collision_rules) == 0)
     {
-        text_t *text = scene_get_text(scene, text_index);
-        if (text->removed)
+        return;
+    }
+
+    spatial_grid_clear(scene->collision_grid);
+    for (size_t type = 0; type < list_size(scene->type_buckets); type++)
+    {
+        if (!scene_has_collision_rule(scene, type))
         {
-            text_free(list_remove(scene->texts, text_index));
+            continue;
         }
-        else
+        list_t *bucket = list_get(scene->type_buckets, type);
+        for (size_t i = 0; i < list_size(bucket); i++)
         {
-            text_index++;
+            spatial_grid_insert(scene->collision_grid, list_get(bucket, i));
         }
     }
+    spatial_grid_build(scene->collision_grid);
+    spatial_grid_for_each_pair(scene->collision_grid, (grid_pair_handler_t)scene_collide_pair, scene);
+
+    // pairs touching this tick become the previous contacts of the next tick
+    contact_set_t *previous = scene->previous_contacts;
+    scene->previous_contacts = scene->current_contacts;
+    scene->current_contacts = previous;
+    contact_set_clear(scene->current_contacts);
+}
 
-    int image_index = 0;
-    while (image_index < scene_images(scene))
+void scene_check_remove_flags(scene_t *scene)
+{
+    size_t removed_bodies = 0;
+    size_t removed_packages = 0;
+    for (size_t i = 0; i < scene_bodies(scene); i++)
     {
-        image_t *image = scene_get_image(scene, image_index);
-        if (image->removed)
+        body_t *body = scene_get_body(scene, i);
+        if (body_is_removed(body))
         {
-            image_free(list_remove(scene->images, image_index));
+            removed_bodies++;
+            removed_packages += force_index_remove_body(scene->force_index, body);
         }
-        else
+    }
+
+    if (removed_bodies > 0)
+    {
+        contact_set_remove_bodies(scene->previous_contacts);
+        // packages go first, since their aux values may still refer to the bodies
+        if (removed_packages > 0)
+        {
+            list_remove_if(scene->force_packages, (list_predicate_t)force_package_is_removed);
+        }
+        if (list_remove_if(scene->static_bodies, (list_predicate_t)body_is_removed) > 0)
+        {
+            scene->static_bvh_stale = true;
+        }
+        for (size_t i = 0; i < list_size(scene->type_buckets); i++)
         {
-            image_index++;
+            list_remove_if(list_get(scene->type_buckets, i), (list_predicate_t)body_is_removed);
         }
+        // freeing a body removes its label and image, so they go after the bodies
+        list_remove_if(scene->bodies, (list_predicate_t)body_is_removed);
     }
+    list_remove_if(scene->texts, (list_predicate_t)text_is_removed);
+    list_remove_if(scene->images, (list_predicate_t)image_is_removed);
 }
 
 void scene_tick(scene_t *scene, double dt)
 {
+    PROFILE_BEGIN(PROFILE_SCENE_TICK);
+    PROFILE_COUNT(PROFILE_BODIES, scene_bodies(scene));
+    // scene_clear() ticks from inside event handlers, so only release what this tick allocated
+    arena_mark_t frame_start = arena_mark(frame_arena());
+
+    PROFILE_BEGIN(PROFILE_SCENE_FORCES);
     for (size_t i = 0; i < list_size(scene->force_packages); i++)
     {
         force_package_t *force_package = list_get(scene->force_packages, i);
         force_package->forcer(force_package->aux);
     }
+    PROFILE_END(PROFILE_SCENE_FORCES);
 
-    for (size_t i = 0; i < scene_bodies(scene); i++)
-    {
-        body_tick(scene_get_body(scene, i), dt);
-    }
+    PROFILE_BEGIN(PROFILE_SCENE_COLLISION_RULES);
+    scene_check_collision_rules(scene);
+    PROFILE_END(PROFILE_SCENE_COLLISION_RULES);
+
+    PROFILE_BEGIN(PROFILE_SCENE_INTEGRATE);
+    body_store_tick(scene->body_store, dt);
+    PROFILE_END(PROFILE_SCENE_INTEGRATE);
 
+    PROFILE_BEGIN(PROFILE_SCENE_REMOVE);
     scene_check_remove_flags(scene);
+    PROFILE_END(PROFILE_SCENE_REMOVE);
+
+    arena_rewind(frame_arena(), frame_start);
+    PROFILE_END(PROFILE_SCENE_TICK);
 }
 
 size_t scene_texts(scene_t *scene)
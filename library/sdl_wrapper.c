@@ -10,9 +10,13 @@
 #include <SDL2/SDL_mixer.h>
 
 #include "sdl_wrapper.h"
+#include "profile.h"
+#include "arena.h"
 
 const char WINDOW_TITLE[] = "CS 3";
 const double MS_PER_S = 1e3;
+const char DEFAULT_FONT_PATH[] = "fonts/VertigoFLF.ttf";
+const size_t MAX_BATCH_VERTICES = 1 << 16;
 
 /**
  * The coordinate at the center of the screen.
@@ -44,13 +48,95 @@ mouse_handler_t mouse_handler = NULL;
  */
 uint32_t key_start_timestamp;
 /**
- * The value of clock() when time_since_last_tick() was last called.
+ * The value of SDL_GetPerformanceCounter() when time_since_last_tick() was last called.
  * Initially 0.
  */
-clock_t last_clock = 0;
+Uint64 last_counter = 0;
+/**
+ * Wall time not yet consumed by fixed simulation steps, in seconds.
+ */
+double step_accumulator = 0.0;
+/**
+ * How far the render is between the last two simulation steps, from 0 to 1.
+ */
+double step_alpha = 1.0;
+/**
+ * Whether sdl_init_headless() was used, in which case there is no window,
+ * renderer or audio device and every frame advances by headless_dt.
+ */
+bool headless = false;
+double headless_dt = 0.0;
+/**
+ * Texts drawn on top of every scene, or NULL. Not owned, and not part of any scene.
+ */
+list_t *overlay_texts = NULL;
+
+typedef struct window_transform
+{
+    vector_t window_center;
+    double scale;
+} window_transform_t;
+
+/**
+ * The scene-to-window mapping for the frame being drawn.
+ * Recomputed by sdl_clear() so the window is only queried once per frame.
+ */
+window_transform_t frame_transform;
+
+typedef struct geometry_batch
+{
+    SDL_Vertex *vertices;
+    size_t num_vertices;
+    size_t vertex_capacity;
+    int *indices;
+    size_t num_indices;
+    size_t index_capacity;
+} geometry_batch_t;
+
+/**
+ * Triangles of the convex bodies drawn so far this frame, not yet submitted to SDL.
+ */
+geometry_batch_t batch = {.vertices = NULL, .num_vertices = 0, .vertex_capacity = 0,
+                          .indices = NULL, .num_indices = 0, .index_capacity = 0};
+
+typedef struct texture
+{
+    char *image_filename;
+    int image_type;
+    SDL_Texture *texture; // NULL until the image is first drawn
+    bool loaded;
+    size_t ref_count;
+} texture_t;
+
+/**
+ * Every texture with at least one image referencing it, searched by filename and type.
+ */
+list_t *textures = NULL;
+
+typedef struct font_entry
+{
+    char *font_path;
+    int font_size;
+    TTF_Font *font;
+} font_entry_t;
+
+/**
+ * Every font opened so far, searched by path and point size.
+ */
+list_t *fonts = NULL;
 
 // private function declarations
-void sdl_render_image(char *image_name, vector_t coord, vector_t size, int image_type);
+void sdl_render_image(image_t *image, vector_t offset);
+void sdl_render_text_cached(text_t *text, vector_t offset);
+vector_t interpolation_offset(body_t *body, double alpha);
+void texture_destroy(texture_t *texture);
+void font_entry_destroy(font_entry_t *entry);
+void update_frame_transform(void);
+vector_t get_window_position(vector_t scene_pos);
+bool is_convex(const vector_t *points, size_t n);
+void batch_reserve(size_t num_vertices, size_t num_indices);
+void batch_add_polygon(const vector_t *points, size_t n, rgb_color_t color, vector_t offset);
+void batch_flush(void);
 void sdl_render_text(const char *text, vector_t coord, vector_t size, rgb_color_t colour, TTF_Font *font);
 void my_audio_callback(void *userdata, Uint8 *stream, int len);
 void sdl_play_music(char *filename);
@@ -58,14 +144,10 @@ void sdl_play_music(char *filename);
 /** Computes the center of the window in pixel coordinates */
 vector_t get_window_center(void)
 {
-    int *width = malloc(sizeof(*width)),
-        *height = malloc(sizeof(*height));
-    assert(width != NULL);
-    assert(height != NULL);
-    SDL_GetWindowSize(window, width, height);
-    vector_t dimensions = {.x = *width, .y = *height};
-    free(width);
-    free(height);
+    int width;
+    int height;
+    SDL_GetWindowSize(window, &width, &height);
+    vector_t dimensions = {.x = width, .y = height};
     return vec_multiply(0.5, dimensions);
 }
 
@@ -82,18 +164,22 @@ double get_scene_scale(vector_t window_center)
     return x_scale < y_scale ? x_scale : y_scale;
 }
 
+void update_frame_transform(void)
+{
+    frame_transform.window_center = get_window_center();
+    frame_transform.scale = get_scene_scale(frame_transform.window_center);
+}
+
 /** Maps a scene coordinate to a window coordinate */
-vector_t get_window_position(vector_t scene_pos, vector_t window_center)
+vector_t get_window_position(vector_t scene_pos)
 {
     // Scale scene coordinates by the scaling factor
     // and map the center of the scene to the center of the window
-    vector_t scene_center_offset = vec_subtract(scene_pos, center);
-    double scale = get_scene_scale(window_center);
-    vector_t pixel_center_offset = vec_multiply(scale, scene_center_offset);
+    vector_t pixel_center_offset = vec_multiply(frame_transform.scale, vec_subtract(scene_pos, center));
     vector_t pixel = {
-        .x = round(window_center.x + pixel_center_offset.x),
+        .x = round(frame_transform.window_center.x + pixel_center_offset.x),
         // Flip y axis since positive y is down on the screen
-        .y = round(window_center.y - pixel_center_offset.y)};
+        .y = round(frame_transform.window_center.y - pixel_center_offset.y)};
     return pixel;
 }
 
@@ -153,8 +239,25 @@ void sdl_init(vector_t min, vector_t max)
     }
 }
 
+void sdl_init_headless(vector_t min, vector_t max, double dt)
+{
+    // Check parameters
+    assert(min.x < max.x);
+    assert(min.y < max.y);
+    assert(dt > 0);
+
+    center = vec_multiply(0.5, vec_add(min, max));
+    max_diff = vec_subtract(max, center);
+    headless = true;
+    headless_dt = dt;
+}
+
 bool sdl_is_done(void *object)
 {
+    if (headless)
+    {
+        return false;
+    }
     SDL_Event *event = malloc(sizeof(*event));
     assert(event != NULL);
     while (SDL_PollEvent(event))
@@ -200,91 +303,262 @@ bool sdl_is_done(void *object)
 
 void sdl_clear(void)
 {
+    if (headless)
+    {
+        return;
+    }
     SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
     SDL_RenderClear(renderer);
+    update_frame_transform();
 }
 
 void sdl_draw_polygon(list_t *points, rgb_color_t color)
+{
+    polygon_t *polygon = polygon_from_list(points);
+    sdl_draw_points(polygon->points, polygon->size, color);
+    polygon_free(polygon);
+}
+
+void sdl_draw_points(const vector_t *points, size_t n, rgb_color_t color)
 {
     // Check parameters
-    size_t n = list_size(points);
     assert(n >= 3);
     assert(0 <= color.r && color.r <= 1);
     assert(0 <= color.g && color.g <= 1);
     assert(0 <= color.b && color.b <= 1);
+    if (headless)
+    {
+        return;
+    }
 
-    vector_t window_center = get_window_center();
+    // keep the draw order of anything already queued
+    batch_flush();
+    update_frame_transform();
 
     // Convert each vertex to a point on screen
-    int16_t *x_points = malloc(sizeof(*x_points) * n),
-            *y_points = malloc(sizeof(*y_points) * n);
-    assert(x_points != NULL);
-    assert(y_points != NULL);
+    arena_mark_t mark = arena_mark(frame_arena());
+    int16_t *x_points = arena_alloc(frame_arena(), sizeof(*x_points) * n),
+            *y_points = arena_alloc(frame_arena(), sizeof(*y_points) * n);
     for (size_t i = 0; i < n; i++)
     {
-        vector_t *vertex = list_get(points, i);
-        vector_t pixel = get_window_position(*vertex, window_center);
+        vector_t pixel = get_window_position(points[i]);
         x_points[i] = (int16_t)pixel.x;
         y_points[i] = (int16_t)pixel.y;
     }
 
     // Draw polygon with the given color
+    PROFILE_COUNT(PROFILE_DRAW_CALLS, 1);
     filledPolygonRGBA(
         renderer,
         x_points, y_points, (int)n,
         (Uint8)(color.r * 255), (Uint8)(color.g * 255), (Uint8)(color.b * 255), 255);
-    free(x_points);
-    free(y_points);
+    arena_rewind(frame_arena(), mark);
+}
+
+bool is_convex(const vector_t *points, size_t n)
+{
+    bool has_positive = false;
+    bool has_negative = false;
+    for (size_t i = 0; i < n; i++)
+    {
+        vector_t edge1 = vec_subtract(points[(i + 1) % n], points[i]);
+        vector_t edge2 = vec_subtract(points[(i + 2) % n], points[(i + 1) % n]);
+        double turn = vec_cross(edge1, edge2);
+        if (turn > 0)
+        {
+            has_positive = true;
+        }
+        else if (turn < 0)
+        {
+            has_negative = true;
+        }
+        if (has_positive && has_negative)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void batch_reserve(size_t num_vertices, size_t num_indices)
+{
+    if (batch.num_vertices + num_vertices > batch.vertex_capacity)
+    {
+        size_t capacity = batch.vertex_capacity == 0 ? num_vertices : batch.vertex_capacity;
+        while (capacity < batch.num_vertices + num_vertices)
+        {
+            capacity *= 2;
+        }
+        batch.vertices = realloc(batch.vertices, capacity * sizeof(SDL_Vertex));
+        assert(batch.vertices != NULL);
+        batch.vertex_capacity = capacity;
+    }
+    if (batch.num_indices + num_indices > batch.index_capacity)
+    {
+        size_t capacity = batch.index_capacity == 0 ? num_indices : batch.index_capacity;
+        while (capacity < batch.num_indices + num_indices)
+        {
+            capacity *= 2;
+        }
+        batch.indices = realloc(batch.indices, capacity * sizeof(int));
+        assert(batch.indices != NULL);
+        batch.index_capacity = capacity;
+    }
+}
+
+void batch_add_polygon(const vector_t *points, size_t n, rgb_color_t color, vector_t offset)
+{
+    assert(n >= 3);
+    assert(0 <= color.r && color.r <= 1);
+    assert(0 <= color.g && color.g <= 1);
+    assert(0 <= color.b && color.b <= 1);
+
+    if (!is_convex(points, n))
+    {
+        // a fan would fill outside the outline, so let gfx scanline it instead
+        arena_mark_t mark = arena_mark(frame_arena());
+        vector_t *moved = arena_alloc(frame_arena(), n * sizeof(vector_t));
+        for (size_t i = 0; i < n; i++)
+        {
+            moved[i] = vec_add(points[i], offset);
+        }
+        sdl_draw_points(moved, n, color);
+        arena_rewind(frame_arena(), mark);
+        return;
+    }
+    if (batch.num_vertices + n > MAX_BATCH_VERTICES)
+    {
+        batch_flush();
+    }
+    batch_reserve(n, 3 * (n - 2));
+
+    SDL_Color vertex_color = {.r = (Uint8)(color.r * 255), .g = (Uint8)(color.g * 255),
+                              .b = (Uint8)(color.b * 255), .a = 255};
+    int first = (int)batch.num_vertices;
+    for (size_t i = 0; i < n; i++)
+    {
+        vector_t pixel = get_window_position(vec_add(points[i], offset));
+        batch.vertices[batch.num_vertices++] = (SDL_Vertex){
+            .position = {.x = (float)pixel.x, .y = (float)pixel.y},
+            .color = vertex_color,
+            .tex_coord = {.x = 0, .y = 0}};
+    }
+    // convex, so a fan around the first vertex covers the polygon exactly
+    for (size_t i = 1; i + 1 < n; i++)
+    {
+        batch.indices[batch.num_indices++] = first;
+        batch.indices[batch.num_indices++] = first + (int)i;
+        batch.indices[batch.num_indices++] = first + (int)i + 1;
+    }
+}
+
+void batch_flush(void)
+{
+    if (batch.num_indices > 0)
+    {
+        PROFILE_COUNT(PROFILE_DRAW_CALLS, 1);
+        SDL_RenderGeometry(renderer, NULL, batch.vertices, (int)batch.num_vertices,
+                           batch.indices, (int)batch.num_indices);
+    }
+    batch.num_vertices = 0;
+    batch.num_indices = 0;
 }
 
 void sdl_show(void)
 {
+    if (headless)
+    {
+        return;
+    }
+    batch_flush();
+
     // Draw boundary lines
-    vector_t window_center = get_window_center();
+    update_frame_transform();
     vector_t max = vec_add(center, max_diff),
              min = vec_subtract(center, max_diff);
-    vector_t max_pixel = get_window_position(max, window_center),
-             min_pixel = get_window_position(min, window_center);
-    SDL_Rect *boundary = malloc(sizeof(*boundary));
-    boundary->x = (int)min_pixel.x;
-    boundary->y = (int)max_pixel.y;
-    boundary->w = (int)max_pixel.x - (int)min_pixel.x;
-    boundary->h = (int)min_pixel.y - (int)max_pixel.y;
+    vector_t max_pixel = get_window_position(max),
+             min_pixel = get_window_position(min);
+    SDL_Rect boundary;
+    boundary.x = (int)min_pixel.x;
+    boundary.y = (int)max_pixel.y;
+    boundary.w = (int)max_pixel.x - (int)min_pixel.x;
+    boundary.h = (int)min_pixel.y - (int)max_pixel.y;
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderDrawRect(renderer, boundary);
-    free(boundary);
+    SDL_RenderDrawRect(renderer, &boundary);
 
     SDL_RenderPresent(renderer);
 }
 
 void sdl_render_scene(scene_t *scene)
 {
+    sdl_render_scene_interpolated(scene, 1.0);
+}
+
+/** How far a body is drawn from its centroid, NULL for a text or image that doesn't belong to a body */
+vector_t interpolation_offset(body_t *body, double alpha)
+{
+    if (body == NULL || alpha >= 1.0)
+    {
+        return VEC_ZERO;
+    }
+    return vec_subtract(body_get_interpolated_centroid(body, alpha), body_get_centroid(body));
+}
+
+void sdl_render_scene_interpolated(scene_t *scene, double alpha)
+{
+    if (headless)
+    {
+        return;
+    }
+    PROFILE_BEGIN(PROFILE_RENDER);
+    arena_mark_t frame_start = arena_mark(frame_arena());
     sdl_clear();
 
+    PROFILE_BEGIN(PROFILE_RENDER_POLYGONS);
     size_t body_count = scene_bodies(scene);
     for (size_t i = 0; i < body_count; i++)
     {
         body_t *body = scene_get_body(scene, i);
-        list_t *shape = body_get_shape(body);
-        sdl_draw_polygon(shape, body_get_color(body));
-        list_free(shape);
+        size_t num_points;
+        const vector_t *shape = body_peek_shape(body, &num_points);
+        batch_add_polygon(shape, num_points, body_get_color(body), interpolation_offset(body, alpha));
     }
+    batch_flush();
+    PROFILE_END(PROFILE_RENDER_POLYGONS);
 
+    PROFILE_BEGIN(PROFILE_RENDER_TEXT);
     size_t text_count = scene_texts(scene);
     for (size_t i = 0; i < text_count; i++)
     {
         text_t *text = scene_get_text(scene, i);
-        sdl_render_text(text->txt, text->position, text->size, text->color, text->font);
+        sdl_render_text_cached(text, interpolation_offset(text->owner, alpha));
+    }
+    if (overlay_texts != NULL)
+    {
+        for (size_t i = 0; i < list_size(overlay_texts); i++)
+        {
+            sdl_render_text_cached(list_get(overlay_texts, i), VEC_ZERO);
+        }
     }
+    PROFILE_END(PROFILE_RENDER_TEXT);
 
+    PROFILE_BEGIN(PROFILE_RENDER_IMAGES);
     size_t image_count = scene_images(scene);
     for (size_t i = 0; i < image_count; i++)
     {
         image_t *image = scene_get_image(scene, i);
-        sdl_render_image(image->image_filename, image->position, image->size, image->image_type);
+        sdl_render_image(image, interpolation_offset(image->owner, alpha));
     }
+    PROFILE_END(PROFILE_RENDER_IMAGES);
 
     sdl_show();
+    arena_rewind(frame_arena(), frame_start);
+    PROFILE_END(PROFILE_RENDER);
+}
+
+void sdl_set_overlay(list_t *texts)
+{
+    overlay_texts = texts;
 }
 
 void sdl_on_key(key_handler_t handler)
@@ -299,14 +573,43 @@ void sdl_on_mouse(mouse_handler_t handler)
 
 double time_since_last_tick(void)
 {
-    clock_t now = clock();
-    double difference = last_clock
-                            ? (double)(now - last_clock) / CLOCKS_PER_SEC
+    if (headless)
+    {
+        return headless_dt;
+    }
+    // wall time, so time spent waiting on the GPU or the OS still counts
+    Uint64 now = SDL_GetPerformanceCounter();
+    double difference = last_counter
+                            ? (double)(now - last_counter) / SDL_GetPerformanceFrequency()
                             : 0.0; // return 0 the first time this is called
-    last_clock = now;
+    last_counter = now;
     return difference;
 }
 
+size_t sdl_fixed_steps(double step, size_t max_steps)
+{
+    assert(step > 0);
+    step_accumulator += time_since_last_tick();
+    size_t steps = 0;
+    while (step_accumulator >= step && steps < max_steps)
+    {
+        step_accumulator -= step;
+        steps++;
+    }
+    if (step_accumulator >= step)
+    {
+        // too far behind to catch up, so drop the backlog instead of spiralling
+        step_accumulator = fmod(step_accumulator, step);
+    }
+    step_alpha = step_accumulator / step;
+    return steps;
+}
+
+double sdl_step_alpha(void)
+{
+    return step_alpha;
+}
+
 void sdl_delay(int number_of_seconds)
 {
     // Converting time into milli_seconds
@@ -343,19 +646,130 @@ void sdl_render_text(const char *text, vector_t coord, vector_t size, rgb_color_
     SDL_DestroyTexture(texture);
 }
 
+void sdl_render_text_cached(text_t *text, vector_t offset)
+{
+    // only rasterize again after text_set(), text_set_color() or text_set_font()
+    if (text->dirty)
+    {
+        if (text->texture != NULL)
+        {
+            SDL_DestroyTexture(text->texture);
+            text->texture = NULL;
+        }
+        SDL_Color color;
+        color.r = (int)(text->color.r * 255);
+        color.g = (int)(text->color.g * 255);
+        color.b = (int)(text->color.b * 255);
+        color.a = 0;
+        PROFILE_COUNT(PROFILE_TEXTS_RASTERIZED, 1);
+        SDL_Surface *surface = TTF_RenderText_Solid(text->font, text->txt, color);
+        if (surface != NULL)
+        {
+            text->texture = SDL_CreateTextureFromSurface(renderer, surface);
+            SDL_FreeSurface(surface);
+        }
+        text->dirty = false;
+    }
+
+    vector_t coord = vec_add(text->position, offset);
+    SDL_Rect rect;
+    rect.x = (int)(coord.x - text->size.x / 2);
+    rect.y = WINDOW_HEIGHT - (int)(coord.y + text->size.y / 2);
+    rect.w = (int)text->size.x;
+    rect.h = (int)text->size.y;
+    PROFILE_COUNT(PROFILE_DRAW_CALLS, 1);
+    SDL_RenderCopy(renderer, text->texture, NULL, &rect);
+}
+
 TTF_Font *create_font(const char *font_path, int font_size)
 {
-    TTF_Font *font = TTF_OpenFont(font_path, font_size);
-    if (font)
+    if (fonts == NULL)
+    {
+        fonts = list_init(1, (free_func_t)font_entry_destroy);
+    }
+    for (size_t i = 0; i < list_size(fonts); i++)
+    {
+        font_entry_t *entry = list_get(fonts, i);
+        if (entry->font_size == font_size && strcmp(entry->font_path, font_path) == 0)
+        {
+            return entry->font;
+        }
+    }
+
+    // nothing is ever drawn without a window, so don't open any font files
+    PROFILE_BEGIN(PROFILE_ASSET_LOAD);
+    TTF_Font *font = headless ? NULL : TTF_OpenFont(font_path, font_size);
+    PROFILE_END(PROFILE_ASSET_LOAD);
+    if (font == NULL && !headless && strcmp(font_path, DEFAULT_FONT_PATH) != 0)
+    {
+        // cache the fallback under the requested path so the missing file isn't retried
+        font = create_font(DEFAULT_FONT_PATH, font_size);
+    }
+
+    font_entry_t *entry = malloc(sizeof(font_entry_t));
+    assert(entry != NULL);
+    entry->font_path = malloc(strlen(font_path) + 1);
+    assert(entry->font_path != NULL);
+    strcpy(entry->font_path, font_path);
+    entry->font_size = font_size;
+    entry->font = font;
+    list_add(fonts, entry);
+    return font;
+}
+
+void sdl_preload_fonts(const char *const *font_paths, const int *font_sizes, size_t num_fonts)
+{
+    for (size_t i = 0; i < num_fonts; i++)
     {
-        return TTF_OpenFont(font_path, font_size);
+        create_font(font_paths[i], font_sizes[i]);
     }
-    // if font is NULL
-    return TTF_OpenFont("fonts/VertigoFLF.ttf", font_size); // default font
+}
+
+void font_entry_destroy(font_entry_t *entry)
+{
+    free(entry->font_path);
+    free(entry);
 }
 
 void sdl_cleanup()
 {
+    if (textures != NULL)
+    {
+        list_free(textures);
+        textures = NULL;
+    }
+    if (fonts != NULL)
+    {
+        // fallback entries share the default font's handle, so close each handle once
+        for (size_t i = 0; i < list_size(fonts); i++)
+        {
+            font_entry_t *entry = list_get(fonts, i);
+            if (entry->font == NULL)
+            {
+                continue;
+            }
+            for (size_t j = i + 1; j < list_size(fonts); j++)
+            {
+                font_entry_t *other = list_get(fonts, j);
+                if (other->font == entry->font)
+                {
+                    other->font = NULL;
+                }
+            }
+            TTF_CloseFont(entry->font);
+        }
+        list_free(fonts);
+        fonts = NULL;
+    }
+    free(batch.vertices);
+    free(batch.indices);
+    batch = (geometry_batch_t){.vertices = NULL, .num_vertices = 0, .vertex_capacity = 0,
+                               .indices = NULL, .num_indices = 0, .index_capacity = 0};
+    if (headless)
+    {
+        headless = false;
+        return;
+    }
     IMG_Quit();
     TTF_Quit();
     SDL_DestroyRenderer(renderer);
@@ -363,22 +777,95 @@ void sdl_cleanup()
     SDL_Quit();
 }
 
-void sdl_render_image(char *image_name, vector_t coord, vector_t size, int image_type)
+texture_t *sdl_texture_acquire(const char *image_filename, int image_type)
 {
-    IMG_Init(image_type);
-    SDL_Surface *surface = IMG_Load(image_name);
-    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_FreeSurface(surface);
+    if (textures == NULL)
+    {
+        textures = list_init(1, (free_func_t)texture_destroy);
+    }
+    for (size_t i = 0; i < list_size(textures); i++)
+    {
+        texture_t *texture = list_get(textures, i);
+        if (texture->image_type == image_type && strcmp(texture->image_filename, image_filename) == 0)
+        {
+            texture->ref_count++;
+            return texture;
+        }
+    }
+
+    texture_t *texture = malloc(sizeof(texture_t));
+    assert(texture != NULL);
+    texture->image_filename = malloc(strlen(image_filename) + 1);
+    assert(texture->image_filename != NULL);
+    strcpy(texture->image_filename, image_filename);
+    texture->image_type = image_type;
+    texture->texture = NULL;
+    texture->loaded = false;
+    texture->ref_count = 1;
+    list_add(textures, texture);
+    return texture;
+}
+
+void sdl_texture_release(texture_t *texture)
+{
+    if (texture == NULL || textures == NULL)
+    {
+        return;
+    }
+    assert(texture->ref_count > 0);
+    texture->ref_count--;
+    if (texture->ref_count > 0)
+    {
+        return;
+    }
+    for (size_t i = 0; i < list_size(textures); i++)
+    {
+        if (list_get(textures, i) == texture)
+        {
+            texture_destroy(list_remove(textures, i));
+            return;
+        }
+    }
+}
+
+void texture_destroy(texture_t *texture)
+{
+    if (texture->texture != NULL)
+    {
+        SDL_DestroyTexture(texture->texture);
+    }
+    free(texture->image_filename);
+    free(texture);
+}
+
+void sdl_render_image(image_t *image, vector_t offset)
+{
+    texture_t *texture = image->texture;
+    if (!texture->loaded)
+    {
+        // decode the file once, on the first frame it is drawn
+        PROFILE_BEGIN(PROFILE_ASSET_LOAD);
+        IMG_Init(texture->image_type);
+        SDL_Surface *surface = IMG_Load(texture->image_filename);
+        if (surface != NULL)
+        {
+            texture->texture = SDL_CreateTextureFromSurface(renderer, surface);
+            SDL_FreeSurface(surface);
+        }
+        texture->loaded = true;
+        PROFILE_END(PROFILE_ASSET_LOAD);
+    }
 
     //'rect' defines the dimensions of the rendering sprite on window
+    vector_t coord = vec_add(image->position, offset);
+    vector_t size = image->size;
     SDL_Rect rect;
     rect.x = (int)(coord.x - size.x / 2);
     rect.y = WINDOW_HEIGHT - (int)(coord.y + size.y / 2);
     rect.w = (int)size.x;
     rect.h = (int)size.y;
-    SDL_RenderCopy(renderer, texture, NULL, &rect);
-
-    SDL_DestroyTexture(texture);
+    PROFILE_COUNT(PROFILE_DRAW_CALLS, 1);
+    SDL_RenderCopy(renderer, texture->texture, NULL, &rect);
 }
 
 // Music Code Source: https://gist.github.com/armornick/3447121
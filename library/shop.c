@@ -33,7 +33,8 @@ typedef struct shop_item
 
 // private function declarations
 char *shop_price_label(int cost);
-bool is_within_path(body_t *path_body, vector_t mouse_pos, scene_t *scene, double radius);
+bool is_within_path(vector_t mouse_pos, scene_t *scene, double radius);
+bool is_within_path_body(body_t *path_body, vector_t mouse_pos, double radius);
 bool is_within_window(vector_t mouse_pos, double demo_playing_width, double demo_playing_height, double radius);
 bool overlap_with_towers(vector_t mouse_pos, scene_t *scene, double radius);
 
@@ -71,9 +72,10 @@ body_t *create_shop_item_body(scene_t *scene, global_body_type_t global_type, in
         }
         vector_t size = {35, 30};
         TTF_Font *font = create_font("fonts/futura.ttf", SHOP_BUTTON_FONT_SIZE);
-        global_body_info_t *info = create_global_body_info(shop_item_info, SHOP_TYPE);
+        global_body_info_t *info = create_global_body_info(shop_item_info);
         body_t *shop_item_body = body_init_with_info_with_label(shop_item_shape, ITEM_MASS, tower_get_color(specific_type), info, free, price_label, SHOP_TEXT_COLOR, font, size);
-        scene_add_body(scene, shop_item_body);
+        body_set_type(shop_item_body, SHOP_TYPE);
+        scene_add_static_body(scene, shop_item_body);
         free(price_label); // free because text_init mallocs again
         return shop_item_body;
     }
@@ -84,9 +86,10 @@ body_t *create_shop_item_body(scene_t *scene, global_body_type_t global_type, in
         char *price_label = shop_price_label(shop_item_info->cost);
         vector_t size = {25, 25};
         TTF_Font *font = create_font("fonts/futura.ttf", SHOP_BUTTON_FONT_SIZE);
-        global_body_info_t *info = create_global_body_info(shop_item_info, SHOP_TYPE);
+        global_body_info_t *info = create_global_body_info(shop_item_info);
         body_t *shop_item_body = body_init_with_info_with_label(shop_item_shape, ITEM_MASS, tool_get_from_id(specific_type).color, info, free, price_label, SHOP_TEXT_COLOR, font, size);
-        scene_add_body(scene, shop_item_body);
+        body_set_type(shop_item_body, SHOP_TYPE);
+        scene_add_static_body(scene, shop_item_body);
         free(price_label); // free because text_init mallocs again
         return shop_item_body;
     }
@@ -166,7 +169,7 @@ void shop_reset_game_state(game_state_t *game_state, bool successful_purchase)
     game_state->last_clicked_item_type = NOTHING;
     game_state->specific_shop_item_selected = 0;
     game_state->purchased_item_cost = 0;
-    game_state->last_tower_selected = NULL;
+    game_state->last_tower_selected = BODY_HANDLE_NONE;
 
     shop_undisplay_description(game_state);
     undisplay_help(game_state);
@@ -215,7 +218,7 @@ void shop_purchase_tower_upgrade(body_t *tower_body, game_state_t *game_state)
         if (game_state->money - upgrade->price >= 0)
         {
             game_state->money -= upgrade->price;
-            body_set_info(tower_body, create_global_body_info(upgrade, TOWER_TYPE));
+            body_set_info(tower_body, create_global_body_info(upgrade));
             body_set_color(tower_body, color_shade(body_get_color(tower_body)));
         }
     }
@@ -253,7 +256,7 @@ void shop_purchase_tower_upgrade(body_t *tower_body, game_state_t *game_state)
         if (game_state->money - upgrade->price >= 0)
         {
             game_state->money -= upgrade->price;
-            body_set_info(tower_body, create_global_body_info(upgrade, TOWER_TYPE));
+            body_set_info(tower_body, create_global_body_info(upgrade));
             body_set_color(tower_body, color_shade(body_get_color(tower_body)));
         }
     }
@@ -291,7 +294,7 @@ void shop_purchase_tower_upgrade(body_t *tower_body, game_state_t *game_state)
         if (game_state->money - upgrade->price >= 0)
         {
             game_state->money -= upgrade->price;
-            body_set_info(tower_body, create_global_body_info(upgrade, TOWER_TYPE));
+            body_set_info(tower_body, create_global_body_info(upgrade));
             body_set_color(tower_body, color_shade(body_get_color(tower_body)));
         }
     }
@@ -304,7 +307,7 @@ void shop_purchase_tower_upgrade(body_t *tower_body, game_state_t *game_state)
 
 void shop_display_upgrade_button(body_t *tower_body, game_state_t *game_state)
 {
-    game_state->last_tower_selected = tower_body;
+    game_state->last_tower_selected = body_get_handle(tower_body);
     game_state->last_clicked_item_type = TOWER_TYPE;
     scene_t *scene = game_state->scene;
     tower_t *tower_info = (tower_t *)get_global_secondary_info(tower_body);
@@ -317,7 +320,7 @@ void shop_display_upgrade_button(body_t *tower_body, game_state_t *game_state)
         vector_t upgrade_text_size = (vector_t){.x = UPGRADE_BUTTON_WIDTH, .y = UPGRADE_BUTTON_HEIGHT};
         list_t *button_shape = polygon_make_rectangle(corner.x, corner.y, corner.x + UPGRADE_BUTTON_WIDTH,
                                                       corner.y + UPGRADE_BUTTON_HEIGHT);
-        global_body_info_t *info = create_global_body_info(NULL, UPGRADE_BUTTON_TYPE);
+        global_body_info_t *info = create_global_body_info(NULL);
         TTF_Font *font = create_font("fonts/futura.ttf", SHOP_BUTTON_FONT_SIZE);
         char *label = malloc(sizeof(char) * 50);
         *label = '\0';
@@ -336,8 +339,9 @@ void shop_display_upgrade_button(body_t *tower_body, game_state_t *game_state)
 
         body_t *button = body_init_with_info_with_label(button_shape, ITEM_MASS, tower_get_color(tower_id),
                                                         info, NULL, label, SHOP_TEXT_COLOR, font, upgrade_text_size);
+        body_set_type(button, UPGRADE_BUTTON_TYPE);
         free(label); // free because text_init mallocs again
-        scene_add_body(scene, button);
+        scene_add_static_body(scene, button);
 
         shop_display_description(game_state, tower_body);
     }
@@ -384,13 +388,10 @@ void shop_undisplay_description(game_state_t *game_state)
 
 void tower_undisplay_upgrade_button(scene_t *scene)
 {
-    for (int i = 0; i < scene_bodies(scene); i++)
+    list_t *upgrade_buttons = scene_get_bodies_of_type(scene, UPGRADE_BUTTON_TYPE);
+    for (size_t i = 0; i < list_size(upgrade_buttons); i++)
     {
-        body_t *body = scene_get_body(scene, i);
-        if (get_global_type(body) == UPGRADE_BUTTON_TYPE)
-        {
-            scene_remove_body(scene, i);
-        }
+        body_remove(list_get(upgrade_buttons, i));
     }
 }
 
@@ -400,18 +401,34 @@ bool is_within_window(vector_t mouse_pos, double demo_playing_width, double demo
 }
 
 // checks if mouse_pos (vector_t) is within the area of the path
-// if so, adjusts mouse position and returns new position
-bool is_within_path(body_t *path_body, vector_t mouse_pos, scene_t *scene, double radius) // private
+bool is_within_path(vector_t mouse_pos, scene_t *scene, double radius) // private
+{
+    list_t *nearby = list_init(1, NULL);
+    scene_query_static(scene, mouse_pos, fmax(radius, 0), nearby);
+    bool within = false;
+    for (size_t i = 0; i < list_size(nearby) && !within; i++)
+    {
+        body_t *path_body = list_get(nearby, i);
+        if (get_global_type(path_body) == PATH_TYPE)
+        {
+            within = is_within_path_body(path_body, mouse_pos, radius);
+        }
+    }
+    list_free(nearby);
+    return within;
+}
+
+bool is_within_path_body(body_t *path_body, vector_t mouse_pos, double radius) // private
 {
-    list_t *vertices = body_get_shape(path_body);
-    size_t size = list_size(vertices);
+    size_t size;
+    const vector_t *vertices = body_peek_shape(path_body, &size);
 
     // for each rectangle
     for (size_t k = 0; k < 0.5 * size - 1; k++)
     {
         // getting opposite corners of rectangle
-        vector_t outer = *((vector_t *)list_get(vertices, k));
-        vector_t inner = *((vector_t *)list_get(vertices, size - (k + 2)));
+        vector_t outer = vertices[k];
+        vector_t inner = vertices[size - (k + 2)];
 
         // checks the opposite of the needed condition
         double min_x = fmin(outer.x, inner.x) - radius;
@@ -433,18 +450,19 @@ bool is_within_path(body_t *path_body, vector_t mouse_pos, scene_t *scene, doubl
 bool overlap_with_towers(vector_t mouse_pos, scene_t *scene, double radius)
 {
     radius *= 2;
-    for (size_t i = 0; i < scene_bodies(scene); i++)
+    list_t *nearby = list_init(1, NULL);
+    scene_query_static(scene, mouse_pos, radius, nearby);
+    bool overlap = false;
+    for (size_t i = 0; i < list_size(nearby) && !overlap; i++)
     {
-        body_t *b = scene_get_body(scene, i);
+        body_t *b = list_get(nearby, i);
         if (get_global_type(b) == TOWER_TYPE)
         {
-            if (vec_distance(body_get_centroid(b), mouse_pos) < radius)
-            {
-                return true;
-            }
+            overlap = vec_distance(body_get_centroid(b), mouse_pos) < radius;
         }
     }
-    return false;
+    list_free(nearby);
+    return overlap;
 }
 
 void shop_place_item(game_state_t *game_state, vector_t mouse_pos, double demo_playing_width, double demo_playing_height)
@@ -452,42 +470,33 @@ void shop_place_item(game_state_t *game_state, vector_t mouse_pos, double demo_p
     global_body_type_t item_id = game_state->global_shop_item_selected;
     bool successful_purchase = false;
 
-    for (size_t i = 0; i < scene_bodies(game_state->scene); i++)
+    scene_t *scene = game_state->scene;
+
+    // create tower at mouse position IF mouse_pos is outside path
+    if (item_id == TOWER_TYPE && !is_within_path(mouse_pos, scene, tower_get_radius()) && is_within_window(mouse_pos, demo_playing_width, demo_playing_height, tower_get_radius()) && !overlap_with_towers(mouse_pos, scene, tower_get_radius()))
     {
-        body_t *path_body = scene_get_body(game_state->scene, i);
-        if (get_global_type(path_body) == PATH_TYPE)
+        int id = game_state->specific_shop_item_selected;
+        body_t *b = create_tower(scene, tower_get_from_id(id), mouse_pos);
+        if (id == AIRPLANE_ID)
         {
-            // create tower at mouse position IF mouse_pos is outside path
-            scene_t *scene = game_state->scene;
-            if (item_id == TOWER_TYPE && !is_within_path(path_body, mouse_pos, scene, tower_get_radius()) && is_within_window(mouse_pos, demo_playing_width, demo_playing_height, tower_get_radius()) && !overlap_with_towers(mouse_pos, scene, tower_get_radius()))
-            {
-                int id = game_state->specific_shop_item_selected;
-                body_t *b = create_tower(scene, tower_get_from_id(id), mouse_pos);
-                if (id == AIRPLANE_ID)
-                {
-                    body_set_centroid(b, (vector_t){.x = mouse_pos.x + tower_get_airplane_flight_radius(), .y = mouse_pos.y});
-                    tower_t *info = get_global_secondary_info(b);
-                    info->flight_center = mouse_pos;
-                }
-                successful_purchase = true;
-                shop_reset_game_state(game_state, successful_purchase);
-                printf("purchased and placed a tower! \n");
-                sound_play(game_state->purchase_sound);
-                break;
-            }
-            else if (item_id == TOOL_TYPE && is_within_path(path_body, mouse_pos, game_state->scene, -0.5 * tool_get_radius()) && is_within_window(mouse_pos, demo_playing_width, demo_playing_height, tool_get_radius()))
-            {
-                // placing tools on the path
-                int id = game_state->specific_shop_item_selected;
-                create_tool(scene, tool_get_from_id(id), mouse_pos);
-                successful_purchase = true;
-                shop_reset_game_state(game_state, successful_purchase);
-                printf("purchased and placed a tool! \n");
-                sound_play(game_state->purchase_sound);
-                break;
-            }
-            shop_undisplay_description(game_state);
+            body_set_centroid(b, (vector_t){.x = mouse_pos.x + tower_get_airplane_flight_radius(), .y = mouse_pos.y});
+            tower_t *info = get_global_secondary_info(b);
+            info->flight_center = mouse_pos;
         }
+        successful_purchase = true;
+        shop_reset_game_state(game_state, successful_purchase);
+        printf("purchased and placed a tower! \n");
+        sound_play(game_state->purchase_sound);
+    }
+    else if (item_id == TOOL_TYPE && is_within_path(mouse_pos, scene, -0.5 * tool_get_radius()) && is_within_window(mouse_pos, demo_playing_width, demo_playing_height, tool_get_radius()))
+    {
+        // placing tools on the path
+        int id = game_state->specific_shop_item_selected;
+        create_tool(scene, tool_get_from_id(id), mouse_pos);
+        successful_purchase = true;
+        shop_reset_game_state(game_state, successful_purchase);
+        printf("purchased and placed a tool! \n");
+        sound_play(game_state->purchase_sound);
     }
 
     if (!successful_purchase)
@@ -500,28 +509,10 @@ void shop_place_item(game_state_t *game_state, vector_t mouse_pos, double demo_p
 void shop_temp_display(game_state_t *game_state, vector_t mouse_pos, double demo_playing_width, double demo_playing_height)
 {
     int type = game_state->global_shop_item_selected;
-    body_t *b = NULL;
-    body_t *path_body = NULL;
     scene_t *scene = game_state->scene;
+    body_t *b = body_from_handle(game_state->shop_item_preview);
 
-    for (size_t i = 0; i < scene_bodies(scene); i++)
-    {
-        body_t *curr_body = scene_get_body(scene, i);
-        if (get_global_type(curr_body) == MOUSE_TYPE)
-        {
-            b = curr_body;
-        }
-        else if (get_global_type(curr_body) == PATH_TYPE)
-        {
-            path_body = curr_body;
-        }
-        if (b != NULL && path_body != NULL)
-        {
-            break;
-        }
-    }
-
-    if (b == NULL)
+    if (b == NULL || body_is_removed(b))
     {
         list_t *shape = NULL;
         if (type == TOWER_TYPE)
@@ -534,25 +525,23 @@ void shop_temp_display(game_state_t *game_state, vector_t mouse_pos, double demo
         }
         b = body_init_with_secondary_info(shape, INFINITY, PASTEL_RED, NULL, NULL, MOUSE_TYPE);
         scene_add_body(game_state->scene, b);
+        game_state->shop_item_preview = body_get_handle(b);
     }
 
     body_set_centroid(b, mouse_pos);
-    if (path_body != NULL)
+    body_set_color(b, PASTEL_RED);
+    if (type == TOWER_TYPE)
     {
-        body_set_color(b, PASTEL_RED);
-        if (type == TOWER_TYPE)
+        if (is_within_window(mouse_pos, demo_playing_width, demo_playing_height, tower_get_radius()) && !is_within_path(mouse_pos, scene, tower_get_radius()) && !overlap_with_towers(mouse_pos, scene, tower_get_radius()))
         {
-            if (is_within_window(mouse_pos, demo_playing_width, demo_playing_height, tower_get_radius()) && !is_within_path(path_body, mouse_pos, scene, tower_get_radius()) && !overlap_with_towers(mouse_pos, scene, tower_get_radius()))
-            {
-                body_set_color(b, PASTEL_GREEN);
-            }
+            body_set_color(b, PASTEL_GREEN);
         }
-        else if (type == TOOL_TYPE)
+    }
+    else if (type == TOOL_TYPE)
+    {
+        if (is_within_window(mouse_pos, demo_playing_width, demo_playing_height, tool_get_radius()) && is_within_path(mouse_pos, scene, -0.5 * tool_get_radius()))
         {
-            if (is_within_window(mouse_pos, demo_playing_width, demo_playing_height, tool_get_radius()) && is_within_path(path_body, mouse_pos, scene, -0.5 * tool_get_radius()))
-            {
-                body_set_color(b, PASTEL_GREEN);
-            }
+            body_set_color(b, PASTEL_GREEN);
         }
     }
 }
@@ -0,0 +1,208 @@
+#include <stdint.h>
+#include "spatial_grid.h"
+
+const size_t INITIAL_GRID_ENTRIES = 64;
+
+typedef struct grid_entry
+{
+    uint64_t cell;   // packed (x, y) cell coordinates, the sort key
+    size_t index;    // insertion order of the body, breaks ties between equal cells
+    body_t *body;
+    vector_t min;    // lower left corner of the body's bounding square
+} grid_entry_t;
+
+typedef struct spatial_grid
+{
+    double cell_size;
+    grid_entry_t *entries;
+    size_t size;
+    size_t capacity;
+    size_t num_bodies;
+} spatial_grid_t;
+
+// PRIVATE HELPER FUNCTION DECLARATIONS
+int64_t grid_coordinate(spatial_grid_t *grid, double x);
+uint64_t grid_cell_key(int64_t x, int64_t y);
+void grid_add_entry(spatial_grid_t *grid, grid_entry_t entry);
+int grid_entry_compare(const void *e1, const void *e2);
+size_t grid_find_cell(spatial_grid_t *grid, uint64_t cell);
+
+spatial_grid_t *spatial_grid_init(double cell_size)
+{
+    assert(cell_size > 0);
+    spatial_grid_t *grid = malloc(sizeof(spatial_grid_t));
+    assert(grid != NULL);
+    grid->cell_size = cell_size;
+    grid->entries = malloc(INITIAL_GRID_ENTRIES * sizeof(grid_entry_t));
+    assert(grid->entries != NULL);
+    grid->size = 0;
+    grid->capacity = INITIAL_GRID_ENTRIES;
+    grid->num_bodies = 0;
+    return grid;
+}
+
+void spatial_grid_free(spatial_grid_t *grid)
+{
+    free(grid->entries);
+    free(grid);
+}
+
+void spatial_grid_clear(spatial_grid_t *grid)
+{
+    grid->size = 0;
+    grid->num_bodies = 0;
+}
+
+int64_t grid_coordinate(spatial_grid_t *grid, double x)
+{
+    return (int64_t)floor(x / grid->cell_size);
+}
+
+uint64_t grid_cell_key(int64_t x, int64_t y)
+{
+    return ((uint64_t)(uint32_t)x << 32) | (uint64_t)(uint32_t)y;
+}
+
+void grid_add_entry(spatial_grid_t *grid, grid_entry_t entry)
+{
+    if (grid->size >= grid->capacity)
+    {
+        grid->capacity *= 2;
+        grid->entries = realloc(grid->entries, grid->capacity * sizeof(grid_entry_t));
+        assert(grid->entries != NULL);
+    }
+    grid->entries[grid->size++] = entry;
+}
+
+void spatial_grid_insert(spatial_grid_t *grid, body_t *body)
+{
+    vector_t centroid = body_get_centroid(body);
+    double size = body_get_size(body);
+    vector_t min = {.x = centroid.x - size, .y = centroid.y - size};
+    vector_t max = {.x = centroid.x + size, .y = centroid.y + size};
+
+    int64_t min_x = grid_coordinate(grid, min.x);
+    int64_t min_y = grid_coordinate(grid, min.y);
+    int64_t max_x = grid_coordinate(grid, max.x);
+    int64_t max_y = grid_coordinate(grid, max.y);
+    for (int64_t x = min_x; x <= max_x; x++)
+    {
+        for (int64_t y = min_y; y <= max_y; y++)
+        {
+            grid_entry_t entry = {.cell = grid_cell_key(x, y), .index = grid->num_bodies,
+                                  .body = body, .min = min};
+            grid_add_entry(grid, entry);
+        }
+    }
+    grid->num_bodies++;
+}
+
+int grid_entry_compare(const void *e1, const void *e2)
+{
+    const grid_entry_t *entry1 = e1;
+    const grid_entry_t *entry2 = e2;
+    if (entry1->cell != entry2->cell)
+    {
+        return entry1->cell < entry2->cell ? -1 : 1;
+    }
+    if (entry1->index != entry2->index)
+    {
+        return entry1->index < entry2->index ? -1 : 1;
+    }
+    return 0;
+}
+
+void spatial_grid_build(spatial_grid_t *grid)
+{
+    qsort(grid->entries, grid->size, sizeof(grid_entry_t), grid_entry_compare);
+}
+
+void spatial_grid_for_each_pair(spatial_grid_t *grid, grid_pair_handler_t handler, void *aux)
+{
+    size_t start = 0;
+    while (start < grid->size)
+    {
+        // find the run of entries in the same cell
+        uint64_t cell = grid->entries[start].cell;
+        size_t end = start + 1;
+        while (end < grid->size && grid->entries[end].cell == cell)
+        {
+            end++;
+        }
+
+        for (size_t i = start; i < end; i++)
+        {
+            grid_entry_t *entry1 = &grid->entries[i];
+            for (size_t j = i + 1; j < end; j++)
+            {
+                grid_entry_t *entry2 = &grid->entries[j];
+
+                // a pair sharing several cells is only reported from the cell that
+                // holds the lower left corner of the overlap of their bounding squares
+                double overlap_x = fmax(entry1->min.x, entry2->min.x);
+                double overlap_y = fmax(entry1->min.y, entry2->min.y);
+                if (grid_cell_key(grid_coordinate(grid, overlap_x),
+                                  grid_coordinate(grid, overlap_y)) == cell)
+                {
+                    handler(entry1->body, entry2->body, aux);
+                }
+            }
+        }
+        start = end;
+    }
+}
+
+// index of the first entry in a cell, or of the first entry after it if the cell is empty
+size_t grid_find_cell(spatial_grid_t *grid, uint64_t cell)
+{
+    size_t low = 0;
+    size_t high = grid->size;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        if (grid->entries[middle].cell < cell)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+void spatial_grid_for_each_near(spatial_grid_t *grid, vector_t center, double radius,
+                                grid_body_handler_t handler, void *aux)
+{
+    vector_t min = {.x = center.x - radius, .y = center.y - radius};
+    int64_t min_x = grid_coordinate(grid, min.x);
+    int64_t min_y = grid_coordinate(grid, min.y);
+    int64_t max_x = grid_coordinate(grid, center.x + radius);
+    int64_t max_y = grid_coordinate(grid, center.y + radius);
+    for (int64_t x = min_x; x <= max_x; x++)
+    {
+        for (int64_t y = min_y; y <= max_y; y++)
+        {
+            uint64_t cell = grid_cell_key(x, y);
+            for (size_t i = grid_find_cell(grid, cell); i < grid->size && grid->entries[i].cell == cell; i++)
+            {
+                // like pairs, a body in several of the cells is only reported from the one
+                // holding the lower left corner of the overlap of the two squares
+                grid_entry_t *entry = &grid->entries[i];
+                double overlap_x = fmax(entry->min.x, min.x);
+                double overlap_y = fmax(entry->min.y, min.y);
+                if (grid_cell_key(grid_coordinate(grid, overlap_x),
+                                  grid_coordinate(grid, overlap_y)) == cell)
+                {
+                    handler(entry->body, entry->index, aux);
+                }
+            }
+        }
+    }
+}
+
+size_t spatial_grid_bodies(spatial_grid_t *grid)
+{
+    return grid->num_bodies;
+}
@@ -8,18 +8,27 @@ text_t *text_init(char *txt, vector_t position, vector_t size, rgb_color_t color
     char *new_text = malloc(sizeof(char) * MAX_TEXT_LENGTH);
     strcpy(new_text, txt);
     *new_text = *txt;
-    *text = (text_t){.txt = new_text, .position = position, .size = size, .color = color, .font = font, .removed = false};
+    *text = (text_t){.txt = new_text, .position = position, .size = size, .color = color, .font = font, .removed = false,
+                     .texture = NULL, .dirty = true};
     return text;
 }
 
 void text_set(text_t *text, char *new_txt)
 {
-    strcpy(text->txt, new_txt);
+    if (strcmp(text->txt, new_txt) != 0)
+    {
+        strcpy(text->txt, new_txt);
+        text->dirty = true;
+    }
     // free(new_txt);
 }
 
 void text_free(text_t *text)
 {
+    if (text->texture != NULL)
+    {
+        SDL_DestroyTexture(text->texture);
+    }
     free(text->txt);
     free(text);
 }
@@ -32,11 +41,13 @@ void text_set_position(text_t *text, vector_t position)
 void text_set_color(text_t *text, rgb_color_t color)
 {
     text->color = color;
+    text->dirty = true;
 }
 
 void text_set_font(text_t *text, TTF_Font *font)
 {
     text->font = font;
+    text->dirty = true;
 }
 
 void text_set_size(text_t *text, vector_t size)
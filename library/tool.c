@@ -47,7 +47,7 @@ body_t *create_tool(scene_t *scene, tool_t tool_info, vector_t position)
     tool_t *tool = malloc(sizeof(tool_t));
     assert(tool != NULL);
     *tool = tool_info;
-    global_body_info_t *global_info = create_global_body_info(tool, TOOL_TYPE);
+    global_body_info_t *global_info = create_global_body_info(tool);
     vector_t size = (vector_t){TOOL_RADIUS * 2, TOOL_RADIUS * 2};
     list_t *tool_shape = polygon_make_square(position, TOOL_RADIUS * 0.5);
 
@@ -67,17 +67,8 @@ body_t *create_tool(scene_t *scene, tool_t tool_info, vector_t position)
 
     body_t *body = body_init_with_info_with_image(tool_shape, TOOL_MASS, tool_get_from_id(tool->id).color,
                                                   global_info, (free_func_t) tool_free, filename, IMG_INIT_PNG, size);
+    body_set_type(body, TOOL_TYPE);
     scene_add_body(scene, body);
-
-    for (size_t i = 0; i < scene_bodies(scene); i++)
-    {
-        body_t *virus_body = scene_get_body(scene, i);
-        if (get_global_type(virus_body) == VIRUS_TYPE)
-        {
-            collision_handler_t force = tool_info.force;
-            create_collision(scene, virus_body, body, force, scene, NULL);
-        }
-    }
     return body;
 }
 
@@ -1,6 +1,9 @@
+#include <stdint.h>
 #include "tower.h"
 #include "math.h"
 #include "sound.h"
+#include "profile.h"
+#include "spatial_grid.h"
 
 /////////////////////////// CONSTS & CONFIGS ////////////////////////////////
 
@@ -27,6 +30,37 @@ const double NORMAL_ALIVE_TIME = 50;
 const double LOW_ALIVE_TIME = 25;
 
 const vector_t BOMB_OFFSET = {.x = 10, .y = 10};
+const double VIRUS_GRID_CELL_SIZE = 100.0; // about a tower range, so a query visits a few cells
+
+const size_t VIRUS_ORDER_INITIAL_CAPACITY = 64;
+
+// where the viruses were at the start of the tick, see tower_index_viruses()
+spatial_grid_t *virus_grid = NULL;
+
+typedef struct ordered_virus
+{
+    body_handle_t handle; // the body is only valid for the tick it was indexed on
+    body_t *body;
+    double progress;
+} ordered_virus_t;
+
+// the viruses from the front of the wave to the back, as of the start of the tick
+typedef struct virus_order
+{
+    ordered_virus_t *viruses;
+    size_t size;
+    size_t capacity;
+} virus_order_t;
+
+virus_order_t virus_order = {.viruses = NULL, .size = 0, .capacity = 0};
+
+typedef struct front_virus_search
+{
+    vector_t tower_position;
+    double radius;
+    body_t *front_virus;
+    size_t front_index; // position of front_virus in the order, SIZE_MAX if none found yet
+} front_virus_search_t;
 
 tower_t tower_make_struct(int price, double range, int upgrade_level, bullet_t bullet_info,
                           int time_counter, int shoot_interval, int bonus,
@@ -199,7 +233,10 @@ void setup_tower_configs()
 //////////////////////////////////////////////////////////////////////////////////////////////
 
 // PRIVATE FUNCTION DECLARATIONS
-body_t *tower_get_front_virus(scene_t *scene, vector_t tower_position, double radius);
+void tower_order_viruses(list_t *viruses);
+bool tower_virus_in_range(vector_t tower_position, double radius);
+void tower_find_virus_in_range(body_t *virus_body, size_t index, front_virus_search_t *search);
+void tower_find_front_virus(body_t *virus_body, size_t index, front_virus_search_t *search);
 vector_t tower_aim(body_t *tower_body, scene_t *scene);
 void tower_shoot_standard(body_t *tower_body, scene_t *scene, game_state_t *game_state, vector_t direction);
 void tower_tack_shoot(body_t *tower_body, scene_t *scene, game_state_t *game_state, bool alwaysActivate);
@@ -207,7 +244,9 @@ void virus_boomerang_collision(body_t *virus_body, body_t *bullet, vector_t axis
 void virus_glue_collision(body_t *virus, body_t *bullet, vector_t axis, game_state_t *game_state);
 void virus_bomb_collision(body_t *virus_body, body_t *bullet, vector_t axis, game_state_t *game_state);
 void virus_bullet_collision(body_t *virus_body, body_t *bullet, vector_t axis, game_state_t *game_state);
-void virus_damage(body_t *virus_body, int damage, game_state_t *game_state);
+void virus_glue_bullet_collision(body_t *virus, body_t *bullet, vector_t axis, game_state_t *game_state);
+void virus_bomb_bullet_collision(body_t *virus_body, body_t *bullet, vector_t axis, game_state_t *game_state);
+collision_handler_t tower_get_virus_handler(tower_id_t tower_id);
 void tower_airplane_bomb(body_t *tower_body, scene_t *scene, game_state_t *game_state);
 void tower_airplane_update(body_t *tower_body, scene_t *scene);
 
@@ -237,12 +276,10 @@ void virus_damage(body_t *virus_body, int damage, game_state_t *game_state)
         {
             for (int i = 0; i < SUPER_VIRUS_SPAWN_COUNT; i++)
             {
-                // spawn viruses from super virus
-                body_t *new_virus_body = create_virus(game_state->scene, SUPER_VIRUS_SPAWN_HEALTH,
-                                                      vec_multiply(SUPER_VIRUS_SPEED_MULTIPLIER + i * 0.05,
-                                                                   body_get_velocity(virus_body)),
-                                                      body_get_centroid(virus_body), game_state, false);
-                virus_set_path_nodes(new_virus_body, virus_get_path_nodes(info));
+                // spawn viruses from super virus, on the path where it was
+                create_virus(game_state->scene, SUPER_VIRUS_SPAWN_HEALTH,
+                             vec_multiply(SUPER_VIRUS_SPEED_MULTIPLIER + i * 0.05, body_get_velocity(virus_body)),
+                             body_get_centroid(virus_body), game_state, false);
             }
         }
 
@@ -276,13 +313,15 @@ void virus_boomerang_collision(body_t *virus_body, body_t *bullet, vector_t axis
 
 void bomb_effect(vector_t position, scene_t *scene, game_state_t *game_state, tower_t bomb_type)
 {
-    tower_t *t = malloc(sizeof(tower_t));
-    *t = bomb_type;
-    body_t *bomb = body_init_with_secondary_info(polygon_make_circle(position, 3, 3),
-                                                 TOWER_MASS, tower_get_color(t->id),
-                                                 t, free, TOWER_TYPE);
-    tower_tack_shoot(bomb, scene, game_state, true);
-    body_free(bomb);
+    // a burst in every direction from the bomb, with no body for the bomb itself
+    bullet_t bullet_info = bomb_type.bullet_info;
+    bullet_info.virus_handler = tower_get_virus_handler(bomb_type.id);
+    int n = bullet_info.num_tack_directions;
+    for (double i = 0; i < 2 * M_PI; i += 2 * M_PI / n)
+    {
+        body_t *bullet = create_basic_bullet(scene, position, tower_get_color(bomb_type.id), bullet_info);
+        body_set_velocity(bullet, vec_multiply(bullet_info.speed, (vector_t){.x = cos(i), .y = sin(i)}));
+    }
 }
 
 void virus_bomb_collision(body_t *virus_body, body_t *bullet, vector_t axis, game_state_t *game_state)
@@ -291,10 +330,11 @@ void virus_bomb_collision(body_t *virus_body, body_t *bullet, vector_t axis, gam
 
     // Damaging all viruses within a radius = bomb explosion
     int radius = 20;
-    for (size_t i = 0; i < scene_bodies(scene); i++)
+    list_t *viruses = scene_get_bodies_of_type(scene, VIRUS_TYPE);
+    for (size_t i = 0; i < list_size(viruses); i++)
     {
-        body_t *body = scene_get_body(scene, i);
-        if (get_global_type(body) == VIRUS_TYPE && vec_magnitude(vec_subtract(body_get_centroid(body), body_get_centroid(virus_body))) <= radius)
+        body_t *body = list_get(viruses, i);
+        if (vec_magnitude(vec_subtract(body_get_centroid(body), body_get_centroid(virus_body))) <= radius)
         {
             virus_damage(body, ((bullet_t *)get_global_secondary_info(bullet))->damage, game_state);
         }
@@ -304,8 +344,37 @@ void virus_bomb_collision(body_t *virus_body, body_t *bullet, vector_t axis, gam
     create_explosion_effect_bullet(scene, body_get_centroid(virus_body));
 }
 
+// glue and bomb bullets also do a standard bullet hit
+void virus_glue_bullet_collision(body_t *virus, body_t *bullet, vector_t axis, game_state_t *game_state)
+{
+    virus_glue_collision(virus, bullet, axis, game_state);
+    virus_bullet_collision(virus, bullet, axis, game_state);
+}
+
+void virus_bomb_bullet_collision(body_t *virus_body, body_t *bullet, vector_t axis, game_state_t *game_state)
+{
+    virus_bomb_collision(virus_body, bullet, axis, game_state);
+    virus_bullet_collision(virus_body, bullet, axis, game_state);
+}
+
+collision_handler_t tower_get_virus_handler(tower_id_t tower_id)
+{
+    switch (tower_id)
+    {
+    case BOMB_SHOOTER_ID:
+        return (collision_handler_t)virus_bomb_bullet_collision;
+    case GLUE_TOWER_ID:
+        return (collision_handler_t)virus_glue_bullet_collision;
+    case BOOMERANG_ID:
+        return (collision_handler_t)virus_boomerang_collision;
+    default:
+        return (collision_handler_t)virus_bullet_collision;
+    }
+}
+
 void tower_tick(body_t *tower_body, scene_t *scene, game_state_t *game_state)
 {
+    PROFILE_BEGIN(PROFILE_TOWER_TICK);
     tower_t *tower = get_global_secondary_info(tower_body);
     int tower_id = tower_get_type(tower_body);
     tower->time_counter++;
@@ -350,6 +419,7 @@ void tower_tick(body_t *tower_body, scene_t *scene, game_state_t *game_state)
     {
         tower->bomb_time_counter++;
     }
+    PROFILE_END(PROFILE_TOWER_TICK);
 }
 
 void tower_airplane_update(body_t *tower_body, scene_t *scene)
@@ -369,6 +439,7 @@ void tower_airplane_update(body_t *tower_body, scene_t *scene)
                               .y = sin(theta) * AIRPLANE_FLIGHT_RADIUS};
     airplane_pos = vec_add(airplane_pos, path_center);
     body_set_centroid(tower_body, airplane_pos);
+    scene_static_body_moved(scene, tower_body);
 }
 
 void tower_airplane_bomb(body_t *tower_body, scene_t *scene, game_state_t *game_state)
@@ -376,38 +447,49 @@ void tower_airplane_bomb(body_t *tower_body, scene_t *scene, game_state_t *game_
     bomb_effect(body_get_centroid(tower_body), scene, game_state, AIRPLANE_BOMB);
 }
 
-body_t *tower_get_front_virus(scene_t *scene, vector_t tower_position, double radius)
+void tower_find_front_virus(body_t *virus_body, size_t index, front_virus_search_t *search)
 {
-    double max = 0.0;
-    body_t *front_virus; // reference variable to the farthest along virus
-    for (size_t i = 0; i < scene_bodies(scene); i++)
+    // the grid was filled from the front of the wave, so a lower index is further along the path
+    if (index < search->front_index &&
+        vec_magnitude(vec_subtract(body_get_centroid(virus_body), search->tower_position)) <= search->radius)
     {
-        body_t *body = scene_get_body(scene, i);
-        if (get_global_type(body) == VIRUS_TYPE)
-        {
-            if (vec_magnitude(vec_subtract(body_get_centroid(body), tower_position)) <= radius)
-            {
-                virus_t *virus = get_global_secondary_info(body);
-                double dist = virus_get_distance_travelled(virus);
-                if (dist > max)
-                {
-                    max = dist;
-                    front_virus = body;
-                }
-            }
-        }
+        search->front_virus = virus_body;
+        search->front_index = index;
     }
-    if (max == 0.0)
+}
+
+body_t *tower_get_front_virus(vector_t tower_position, double radius)
+{
+    assert(virus_grid != NULL);
+    front_virus_search_t search = {.tower_position = tower_position, .radius = radius, .front_virus = NULL,
+                                   .front_index = SIZE_MAX};
+    spatial_grid_for_each_near(virus_grid, tower_position, radius,
+                               (grid_body_handler_t)tower_find_front_virus, &search);
+    return search.front_virus;
+}
+
+void tower_find_virus_in_range(body_t *virus_body, size_t index, front_virus_search_t *search)
+{
+    if (vec_magnitude(vec_subtract(body_get_centroid(virus_body), search->tower_position)) <= search->radius)
     {
-        return NULL;
+        search->front_virus = virus_body;
     }
-    return front_virus;
+}
+
+bool tower_virus_in_range(vector_t tower_position, double radius)
+{
+    assert(virus_grid != NULL);
+    front_virus_search_t search = {.tower_position = tower_position, .radius = radius, .front_virus = NULL,
+                                   .front_index = SIZE_MAX};
+    spatial_grid_for_each_near(virus_grid, tower_position, radius,
+                               (grid_body_handler_t)tower_find_virus_in_range, &search);
+    return search.front_virus != NULL;
 }
 
 vector_t tower_aim(body_t *tower_body, scene_t *scene)
 {
     tower_t *tower = get_global_secondary_info(tower_body);
-    body_t *virus_body = tower_get_front_virus(scene, body_get_centroid(tower_body), tower->range);
+    body_t *virus_body = tower_get_front_virus(body_get_centroid(tower_body), tower->range);
     vector_t direction = VEC_ZERO;
     if (virus_body != NULL)
     {
@@ -427,6 +509,7 @@ void tower_shoot_standard(body_t *tower_body, scene_t *scene, game_state_t *game
 {
     tower_t *tower_info = get_global_secondary_info(tower_body);
     bullet_t bullet_info = tower_info->bullet_info;
+    bullet_info.virus_handler = tower_get_virus_handler(tower_info->id);
 
     if (direction.x == 0 && direction.y == 0)
     {
@@ -443,74 +526,104 @@ void tower_shoot_standard(body_t *tower_body, scene_t *scene, game_state_t *game
     body_set_velocity(bullet, vec_multiply(bullet_speed, direction));
 
     // if pursuit bullet, add gravity
-    body_t *virus_body = tower_get_front_virus(scene, body_get_centroid(tower_body), tower_info->range);
-    if (tower_info->id == AIRPLANE_ID && virus_body)
+    if (tower_info->id == AIRPLANE_ID)
     {
-        create_one_sided_gravity(scene, AIRPLANE_G, bullet, virus_body);
+        body_t *virus_body = tower_get_front_virus(body_get_centroid(tower_body), tower_info->range);
+        if (virus_body)
+        {
+            create_one_sided_gravity(scene, AIRPLANE_G, bullet, virus_body);
+        }
     }
 
-    // Create destructive force between bullet and all viruses
-    for (size_t i = 0; i < scene_bodies(scene); i++)
+    // boomerangs are pulled back to the tower, collisions are handled by the bullet rules
+    if (tower_info->id == BOOMERANG_ID)
     {
-        body_t *curr_body = scene_get_body(scene, i);
-        if (get_global_type(curr_body) == VIRUS_TYPE)
-        {
-            if (tower_info->id == BOMB_SHOOTER_ID)
-            {
-                create_collision(scene, curr_body, bullet,
-                                 (collision_handler_t)virus_bomb_collision, game_state, NULL);
-            }
-            else if (tower_info->id == GLUE_TOWER_ID)
-            {
-                create_collision(scene, curr_body, bullet,
-                                 (collision_handler_t)virus_glue_collision, game_state, NULL);
-            }
-            if (tower_info->id == BOOMERANG_ID)
-            {
-                create_spring(scene, BOOMERANG_SPRING_CONSTANT_K, bullet, tower_body);
-                create_drag(scene, BOOMERANG_DRAG, bullet);
-                create_collision(scene, curr_body, bullet,
-                                 (collision_handler_t)virus_boomerang_collision, game_state, NULL);
-            }
-            else
-            {
-                create_collision(scene, curr_body, bullet,
-                                 (collision_handler_t)virus_bullet_collision, game_state, NULL);
-            }
-        }
-        else if (get_global_type(curr_body) == WALL_TYPE)
-        {
-            create_one_sided_destructive_collision(scene, bullet, curr_body);
-        }
+        create_spring(scene, BOOMERANG_SPRING_CONSTANT_K, bullet, tower_body);
+        create_drag(scene, BOOMERANG_DRAG, bullet);
     }
 }
 
 void tower_tack_shoot(body_t *tower_body, scene_t *scene, game_state_t *game_state, bool alwaysActivate)
 {
     tower_t *tower_info = get_global_secondary_info(tower_body);
-    for (size_t i = 0; i < scene_bodies(scene); i++)
+    if (alwaysActivate || tower_virus_in_range(body_get_centroid(tower_body), tower_info->range))
     {
-        body_t *body = scene_get_body(scene, i);
-        if (get_global_type(body) == VIRUS_TYPE || alwaysActivate)
+        int n = tower_info->bullet_info.num_tack_directions;
+        for (double i = 0; i < 2 * M_PI; i += 2 * M_PI / n)
         {
-            double distance = vec_magnitude(vec_subtract(body_get_centroid(body),
-                                                         body_get_centroid(tower_body)));
-            if ((distance <= tower_info->range) || alwaysActivate)
-            {
-                int n = tower_info->bullet_info.num_tack_directions;
-                for (double i = 0; i < 2 * M_PI; i += 2 * M_PI / n)
-                {
-                    vector_t direction = {.x = cos(i), .y = sin(i)};
-                    tower_shoot_standard(tower_body, scene, game_state, direction);
-                }
-                return;
-            }
+            vector_t direction = {.x = cos(i), .y = sin(i)};
+            tower_shoot_standard(tower_body, scene, game_state, direction);
         }
     }
 }
 
 //////////////////////////////////////////// PUBLIC TOWER FUNCTIONS //////////////////////////////////////////////////
 
+void tower_order_viruses(list_t *viruses)
+{
+    size_t num_viruses = list_size(viruses);
+    if (num_viruses > virus_order.capacity)
+    {
+        virus_order.capacity = num_viruses > 2 * virus_order.capacity ? num_viruses : 2 * virus_order.capacity;
+        if (virus_order.capacity < VIRUS_ORDER_INITIAL_CAPACITY)
+        {
+            virus_order.capacity = VIRUS_ORDER_INITIAL_CAPACITY;
+        }
+        virus_order.viruses = realloc(virus_order.viruses, virus_order.capacity * sizeof(ordered_virus_t));
+        assert(virus_order.viruses != NULL);
+    }
+
+    // drop the viruses that were freed since the last tick
+    size_t kept = 0;
+    for (size_t i = 0; i < virus_order.size; i++)
+    {
+        body_t *body = body_from_handle(virus_order.viruses[i].handle);
+        if (body != NULL)
+        {
+            virus_order.viruses[kept] = virus_order.viruses[i];
+            virus_order.viruses[kept].body = body;
+            kept++;
+        }
+    }
+    assert(kept <= num_viruses);
+
+    // the scene keeps viruses in the order they were added, so the new ones are its last ones
+    for (size_t i = kept; i < num_viruses; i++)
+    {
+        body_t *body = list_get(viruses, i);
+        virus_order.viruses[i] = (ordered_virus_t){.handle = body_get_handle(body), .body = body};
+    }
+    virus_order.size = num_viruses;
+
+    // viruses rarely pass each other, so an insertion sort only makes a few moves
+    for (size_t i = 0; i < virus_order.size; i++)
+    {
+        ordered_virus_t virus = virus_order.viruses[i];
+        virus.progress = virus_get_progress(get_global_secondary_info(virus.body));
+        size_t j = i;
+        for (; j > 0 && virus_order.viruses[j - 1].progress < virus.progress; j--)
+        {
+            virus_order.viruses[j] = virus_order.viruses[j - 1];
+        }
+        virus_order.viruses[j] = virus;
+    }
+}
+
+void tower_index_viruses(scene_t *scene)
+{
+    if (virus_grid == NULL)
+    {
+        virus_grid = spatial_grid_init(VIRUS_GRID_CELL_SIZE);
+    }
+    tower_order_viruses(scene_get_bodies_of_type(scene, VIRUS_TYPE));
+    spatial_grid_clear(virus_grid);
+    for (size_t i = 0; i < virus_order.size; i++)
+    {
+        spatial_grid_insert(virus_grid, virus_order.viruses[i].body);
+    }
+    spatial_grid_build(virus_grid);
+}
+
 body_t *create_tower(scene_t *scene, tower_t tower_info, vector_t position)
 {
     if (tower_info.id == AIRPLANE_ID)
@@ -523,7 +636,8 @@ body_t *create_tower(scene_t *scene, tower_t tower_info, vector_t position)
     list_t *shape = polygon_make_circle(position, TOWER_RADIUS, TOWER_CIRCLE_POINTS);
     body_t *body = body_init_with_secondary_info(shape, TOWER_MASS, tower_get_color(tower->id),
                                                  tower, (free_func_t)tower_free, TOWER_TYPE);
-    scene_add_body(scene, body);
+    // airplanes included, they let the scene know when they move
+    scene_add_static_body(scene, body);
     return body;
 }
 
@@ -558,13 +672,10 @@ void tower_display_range(body_t *tower_body, scene_t *scene)
 
 void tower_undisplay_range(scene_t *scene)
 {
-    for (int i = 0; i < scene_bodies(scene); i++)
+    list_t *range_displays = scene_get_bodies_of_type(scene, TOWER_RANGE_DISPLAY);
+    for (size_t i = 0; i < list_size(range_displays); i++)
     {
-        body_t *body = scene_get_body(scene, i);
-        if (get_global_type(body) == TOWER_RANGE_DISPLAY)
-        {
-            scene_remove_body(scene, i);
-        }
+        body_remove(list_get(range_displays, i));
     }
 }
 
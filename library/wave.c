@@ -0,0 +1,382 @@
+#include "wave.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+const double VIRUS_SPACING = 15;
+const vector_t VIRUS_START_POSITION = {.x = 100, .y = 410};
+const vector_t VIRUS_SPEED = {.x = 100, .y = 0};
+const double VIRUS_SPAWN_X = -15; // just off the left of the screen, where the paths start
+const char WAVE_FILE_MAGIC[4] = {'C', 'T', 'D', 'W'};
+const uint32_t WAVE_FILE_VERSION = 1;
+const size_t WAVE_TABLE_INITIAL_CAPACITY = 64;
+
+// the layout of a table in memory and in a precompiled file:
+// the header, then num_waves + 1 wave starts, then num_viruses viruses
+typedef struct wave_file_header
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t virus_size; // sizeof(wave_virus_t) of the build that wrote the file
+    uint32_t num_waves;
+    uint32_t num_viruses;
+} wave_file_header_t;
+
+typedef struct wave_table
+{
+    char *data;
+    size_t size;
+    bool mapped; // data is a memory-mapped file rather than malloc'd
+    const wave_file_header_t *header;
+    const uint32_t *starts; // wave n is viruses[starts[n], starts[n + 1])
+    const wave_virus_t *viruses;
+} wave_table_t;
+
+// PRIVATE HELPER FUNCTION DECLARATIONS
+wave_table_t *wave_table_wrap(char *data, size_t size, bool mapped);
+void wave_table_release(char *data, size_t size, bool mapped);
+size_t wave_table_data_size(size_t num_waves, size_t num_viruses);
+void wave_spawn_due(scene_t *scene, game_state_t *game_state);
+void *wave_table_grow(void *array, size_t *capacity, size_t needed, size_t element_size);
+
+size_t wave_table_data_size(size_t num_waves, size_t num_viruses)
+{
+    return sizeof(wave_file_header_t) + (num_waves + 1) * sizeof(uint32_t) + num_viruses * sizeof(wave_virus_t);
+}
+
+void *wave_table_grow(void *array, size_t *capacity, size_t needed, size_t element_size)
+{
+    if (needed <= *capacity)
+    {
+        return array;
+    }
+    while (*capacity < needed)
+    {
+        *capacity *= 2;
+    }
+    array = realloc(array, *capacity * element_size);
+    assert(array != NULL);
+    return array;
+}
+
+void wave_spawn_due(scene_t *scene, game_state_t *game_state)
+{
+    wave_spawner_t *spawner = &game_state->spawner;
+    size_t num_viruses;
+    const wave_virus_t *viruses = wave_table_get(game_state->waves, (size_t)spawner->wave, &num_viruses);
+
+    // viruses with the same speed boost reach the spawn line in the order of their line,
+    // so each boost only needs a cursor into the wave
+    for (uint8_t boost = 0; boost < WAVE_SPEED_BOOSTS; boost++)
+    {
+        size_t i = spawner->next[boost];
+        for (; i < num_viruses; i++)
+        {
+            const wave_virus_t *virus = &viruses[i];
+            if (virus->speed_boost != boost)
+            {
+                continue;
+            }
+            // where the virus would be if it had been moving since the wave was loaded
+            vector_t speed = vec_multiply(1 + boost / 10.0, VIRUS_SPEED);
+            vector_t pos = {VIRUS_START_POSITION.x - VIRUS_SPACING * virus->offset, VIRUS_START_POSITION.y};
+            pos = vec_add(pos, vec_multiply(spawner->time, speed));
+            if (pos.x < VIRUS_SPAWN_X)
+            {
+                break;
+            }
+            if (virus->is_super_virus)
+            {
+                create_virus(scene, 40, speed, pos, game_state, true);
+            }
+            else
+            {
+                create_virus(scene, virus->health, speed, pos, game_state, false);
+            }
+            spawner->remaining--;
+        }
+        spawner->next[boost] = i;
+    }
+}
+
+wave_table_t *wave_table_wrap(char *data, size_t size, bool mapped)
+{
+    if (size < sizeof(wave_file_header_t))
+    {
+        return NULL;
+    }
+    const wave_file_header_t *header = (const wave_file_header_t *)data;
+    if (memcmp(header->magic, WAVE_FILE_MAGIC, sizeof(WAVE_FILE_MAGIC)) != 0 ||
+        header->version != WAVE_FILE_VERSION || header->virus_size != sizeof(wave_virus_t) ||
+        size != wave_table_data_size(header->num_waves, header->num_viruses))
+    {
+        return NULL;
+    }
+    const uint32_t *starts = (const uint32_t *)(data + sizeof(wave_file_header_t));
+    if (starts[0] != 0 || starts[header->num_waves] != header->num_viruses)
+    {
+        return NULL;
+    }
+
+    wave_table_t *table = malloc(sizeof(wave_table_t));
+    assert(table != NULL);
+    *table = (wave_table_t){.data = data, .size = size, .mapped = mapped, .header = header, .starts = starts,
+                            .viruses = (const wave_virus_t *)(starts + header->num_waves + 1)};
+    return table;
+}
+
+void wave_table_release(char *data, size_t size, bool mapped)
+{
+#ifndef _WIN32
+    if (mapped)
+    {
+        munmap(data, size);
+        return;
+    }
+#endif
+    free(data);
+}
+
+wave_table_t *wave_table_init(const char *filename)
+{
+    FILE *f = fopen(filename, "r");
+    if (f == NULL)
+    {
+        return NULL;
+    }
+
+    size_t num_waves = 0;
+    size_t num_viruses = 0;
+    size_t starts_capacity = WAVE_TABLE_INITIAL_CAPACITY;
+    size_t viruses_capacity = WAVE_TABLE_INITIAL_CAPACITY;
+    uint32_t *starts = malloc(starts_capacity * sizeof(uint32_t));
+    assert(starts != NULL);
+    wave_virus_t *viruses = malloc(viruses_capacity * sizeof(wave_virus_t));
+    assert(viruses != NULL);
+    starts[0] = 0;
+
+    // read a character at a time, so a wave can be as long as it likes
+    uint32_t column = 0;
+    bool in_line = false;
+    int c;
+    while ((c = getc(f)) != EOF)
+    {
+        if (c == '\n')
+        {
+            starts = wave_table_grow(starts, &starts_capacity, num_waves + 2, sizeof(uint32_t));
+            starts[++num_waves] = (uint32_t)num_viruses;
+            column = 0;
+            in_line = false;
+            continue;
+        }
+        in_line = true;
+        uint32_t offset = ++column;
+        if (c == ' ')
+        {
+            continue;
+        }
+
+        // the speed digit takes up a column of its own
+        uint8_t speed_boost = 0;
+        int next = getc(f);
+        if (next != EOF && isdigit(next))
+        {
+            speed_boost = (uint8_t)(next - '0');
+            column++;
+        }
+        else
+        {
+            ungetc(next, f);
+        }
+
+        bool is_super_virus = c == '!';
+        if (is_super_virus || (c >= 'a' && c <= 'z'))
+        {
+            viruses = wave_table_grow(viruses, &viruses_capacity, num_viruses + 1, sizeof(wave_virus_t));
+            viruses[num_viruses++] = (wave_virus_t){.offset = offset,
+                                                    .health = is_super_virus ? 0 : (uint8_t)(c - 'a' + 1),
+                                                    .speed_boost = speed_boost,
+                                                    .is_super_virus = is_super_virus};
+        }
+    }
+    fclose(f);
+    if (in_line)
+    {
+        starts = wave_table_grow(starts, &starts_capacity, num_waves + 2, sizeof(uint32_t));
+        starts[++num_waves] = (uint32_t)num_viruses;
+    }
+
+    size_t size = wave_table_data_size(num_waves, num_viruses);
+    char *data = malloc(size);
+    assert(data != NULL);
+    wave_file_header_t header = {.version = WAVE_FILE_VERSION, .virus_size = sizeof(wave_virus_t),
+                                 .num_waves = (uint32_t)num_waves, .num_viruses = (uint32_t)num_viruses};
+    memcpy(header.magic, WAVE_FILE_MAGIC, sizeof(WAVE_FILE_MAGIC));
+    memcpy(data, &header, sizeof(header));
+    memcpy(data + sizeof(header), starts, (num_waves + 1) * sizeof(uint32_t));
+    memcpy(data + sizeof(header) + (num_waves + 1) * sizeof(uint32_t), viruses, num_viruses * sizeof(wave_virus_t));
+    free(starts);
+    free(viruses);
+
+    wave_table_t *table = wave_table_wrap(data, size, false);
+    assert(table != NULL);
+    return table;
+}
+
+wave_table_t *wave_table_map(const char *filename)
+{
+    char *data;
+    size_t size;
+    bool mapped;
+#ifdef _WIN32
+    // no mmap, so read the file in one go instead
+    FILE *f = fopen(filename, "rb");
+    if (f == NULL)
+    {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    long length = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (length <= 0)
+    {
+        fclose(f);
+        return NULL;
+    }
+    size = (size_t)length;
+    data = malloc(size);
+    assert(data != NULL);
+    size_t read = fread(data, 1, size, f);
+    fclose(f);
+    if (read != size)
+    {
+        free(data);
+        return NULL;
+    }
+    mapped = false;
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+    {
+        return NULL;
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0)
+    {
+        close(fd);
+        return NULL;
+    }
+    size = (size_t)file_stat.st_size;
+    data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        return NULL;
+    }
+    mapped = true;
+#endif
+
+    wave_table_t *table = wave_table_wrap(data, size, mapped);
+    if (table == NULL)
+    {
+        wave_table_release(data, size, mapped);
+    }
+    return table;
+}
+
+wave_table_t *wave_table_load(const char *filename, const char *precompiled_filename)
+{
+    struct stat source_stat;
+    struct stat precompiled_stat;
+    if (stat(precompiled_filename, &precompiled_stat) == 0)
+    {
+        // a table compiled before the wave file was last edited no longer matches it
+        if (stat(filename, &source_stat) == 0 && precompiled_stat.st_mtime < source_stat.st_mtime)
+        {
+            printf("%s is older than %s, ignoring it\n", precompiled_filename, filename);
+        }
+        else
+        {
+            wave_table_t *table = wave_table_map(precompiled_filename);
+            if (table != NULL)
+            {
+                return table;
+            }
+        }
+    }
+    return wave_table_init(filename);
+}
+
+bool wave_table_write(wave_table_t *table, const char *filename)
+{
+    FILE *f = fopen(filename, "wb");
+    if (f == NULL)
+    {
+        return false;
+    }
+    size_t written = fwrite(table->data, 1, table->size, f);
+    return fclose(f) == 0 && written == table->size;
+}
+
+void wave_table_free(wave_table_t *table)
+{
+    wave_table_release(table->data, table->size, table->mapped);
+    free(table);
+}
+
+size_t wave_table_size(wave_table_t *table)
+{
+    return table->header->num_waves;
+}
+
+const wave_virus_t *wave_table_get(wave_table_t *table, size_t n, size_t *num_viruses)
+{
+    if (n >= table->header->num_waves)
+    {
+        *num_viruses = 0;
+        return table->viruses;
+    }
+    assert(table->starts[n] <= table->starts[n + 1] && table->starts[n + 1] <= table->header->num_viruses);
+    *num_viruses = table->starts[n + 1] - table->starts[n];
+    return &table->viruses[table->starts[n]];
+}
+
+int load_wave(int n, scene_t *scene, game_state_t *game_state)
+{
+    assert(game_state->waves != NULL);
+    assert(n >= 0);
+    size_t num_viruses;
+    const wave_virus_t *viruses = wave_table_get(game_state->waves, (size_t)n, &num_viruses);
+
+    int total_health = 0;
+    for (size_t i = 0; i < num_viruses; i++)
+    {
+        if (viruses[i].is_super_virus)
+        {
+            total_health += SUPER_VIRUS_HEALTH + SUPER_VIRUS_SPAWN_COUNT * SUPER_VIRUS_SPAWN_HEALTH;
+        }
+        else
+        {
+            total_health += viruses[i].health;
+        }
+    }
+
+    game_state->spawner = (wave_spawner_t){.wave = n, .time = 0, .remaining = num_viruses};
+    wave_spawn_due(scene, game_state);
+    return total_health;
+}
+
+void wave_tick(scene_t *scene, game_state_t *game_state, double dt)
+{
+    if (game_state->spawner.remaining == 0)
+    {
+        return;
+    }
+    game_state->spawner.time += dt;
+    wave_spawn_due(scene, game_state);
+}
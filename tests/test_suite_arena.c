@@ -0,0 +1,93 @@
+#include "arena.h"
+#include "test_util.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+void test_alloc_rewind() {
+    arena_t *arena = arena_init(256);
+    size_t capacity = arena_capacity(arena);
+    arena_mark_t start = arena_mark(arena);
+
+    char *first = arena_alloc(arena, 10);
+    char *second = arena_alloc(arena, 10);
+    assert((uintptr_t) first % sizeof(max_align_t) == 0);
+    assert((uintptr_t) second % sizeof(max_align_t) == 0);
+    assert(second >= first + 10);
+    memset(first, 'a', 10);
+    memset(second, 'b', 10);
+    assert(first[9] == 'a');
+
+    // everything after a mark is released, and reused by the next allocations
+    arena_mark_t middle = arena_mark(arena);
+    char *third = arena_alloc(arena, 10);
+    arena_rewind(arena, middle);
+    assert(arena_alloc(arena, 10) == third);
+    arena_rewind(arena, start);
+    assert(arena_alloc(arena, 10) == first);
+    assert(arena_capacity(arena) == capacity);
+
+    arena_reset(arena);
+    assert(arena_alloc(arena, 10) == first);
+    arena_free(arena);
+}
+
+void test_growth() {
+    arena_t *arena = arena_init(256);
+    arena_mark_t start = arena_mark(arena);
+
+    // more than a chunk, and one allocation bigger than a chunk
+    int *small[40];
+    for (size_t i = 0; i < 40; i++) {
+        small[i] = arena_alloc(arena, sizeof(int));
+        *small[i] = i;
+    }
+    double *big = arena_alloc(arena, 1000 * sizeof(double));
+    for (size_t i = 0; i < 1000; i++) {
+        big[i] = i;
+    }
+    for (size_t i = 0; i < 40; i++) {
+        assert(*small[i] == (int) i);
+    }
+    assert(big[999] == 999);
+    size_t capacity = arena_capacity(arena);
+    assert(capacity >= 1000 * sizeof(double) + 40 * sizeof(int));
+
+    // the same allocations again don't need any more memory
+    for (size_t round = 0; round < 10; round++) {
+        arena_rewind(arena, start);
+        for (size_t i = 0; i < 40; i++) {
+            arena_alloc(arena, sizeof(int));
+        }
+        arena_alloc(arena, 1000 * sizeof(double));
+    }
+    assert(arena_capacity(arena) == capacity);
+    arena_free(arena);
+}
+
+void test_frame_arena() {
+    arena_t *arena = frame_arena();
+    assert(arena == frame_arena());
+    arena_mark_t mark = arena_mark(arena);
+    void *memory = arena_alloc(arena, 100);
+    arena_rewind(arena, mark);
+    assert(arena_alloc(arena, 100) == memory);
+    arena_rewind(arena, mark);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_alloc_rewind)
+    DO_TEST(test_growth)
+    DO_TEST(test_frame_arena)
+
+    puts("arena_test PASS");
+}
@@ -30,6 +30,30 @@ void test_body_init() {
     body_free(body);
 }
 
+void test_body_peek_shape() {
+    vector_t v[] = {{1, 1}, {2, 1}, {2, 2}, {1, 2}};
+    const size_t VERTICES = sizeof(v) / sizeof(*v);
+    list_t *shape = list_init(0, free);
+    for (size_t i = 0; i < VERTICES; i++) {
+        vector_t *list_v = malloc(sizeof(*list_v));
+        *list_v = v[i];
+        list_add(shape, list_v);
+    }
+    body_t *body = body_init(shape, 1, (rgb_color_t) {0, 0, 0});
+    size_t num_points;
+    const vector_t *points = body_peek_shape(body, &num_points);
+    assert(num_points == VERTICES);
+    for (size_t i = 0; i < VERTICES; i++) {
+        assert(vec_isclose(points[i], v[i]));
+    }
+    body_set_centroid(body, (vector_t) {0.5, 0.5});
+    points = body_peek_shape(body, &num_points);
+    for (size_t i = 0; i < VERTICES; i++) {
+        assert(vec_isclose(points[i], vec_subtract(v[i], (vector_t) {1, 1})));
+    }
+    body_free(body);
+}
+
 void test_body_setters() {
     list_t *shape = list_init(3, free);
     vector_t *v = malloc(sizeof(*v));
@@ -109,6 +133,177 @@ void test_body_tick() {
     body_free(body);
 }
 
+list_t *make_square() {
+    list_t *shape = list_init(4, free);
+    vector_t *v = malloc(sizeof(*v));
+    *v = (vector_t) {-1, -1};
+    list_add(shape, v);
+    v = malloc(sizeof(*v));
+    *v = (vector_t) {+1, -1};
+    list_add(shape, v);
+    v = malloc(sizeof(*v));
+    *v = (vector_t) {+1, +1};
+    list_add(shape, v);
+    v = malloc(sizeof(*v));
+    *v = (vector_t) {-1, +1};
+    list_add(shape, v);
+    return shape;
+}
+
+void test_body_interpolated_centroid() {
+    const double DT = 0.5;
+    body_store_t *store = body_store_init();
+    body_t *stored = body_init(make_square(), 1, (rgb_color_t) {0, 0, 0});
+    body_t *loose = body_init(make_square(), 1, (rgb_color_t) {0, 0, 0});
+    body_store_add(store, stored);
+    assert(vec_equal(body_get_interpolated_centroid(stored, 0.5), VEC_ZERO));
+
+    body_set_velocity(stored, (vector_t) {4, -2});
+    body_set_velocity(loose, (vector_t) {4, -2});
+    body_store_tick(store, DT);
+    body_tick(loose, DT);
+    assert(vec_isclose(body_get_interpolated_centroid(stored, 0), VEC_ZERO));
+    assert(vec_isclose(body_get_interpolated_centroid(stored, 0.25), (vector_t) {0.5, -0.25}));
+    assert(vec_isclose(body_get_interpolated_centroid(stored, 1), (vector_t) {2, -1}));
+    assert(vec_isclose(body_get_interpolated_centroid(loose, 0.25), (vector_t) {0.5, -0.25}));
+
+    // previous centroid survives moving out of the store
+    body_store_remove(store, stored);
+    assert(vec_isclose(body_get_interpolated_centroid(stored, 0.5), (vector_t) {1, -0.5}));
+
+    // setting the centroid is a jump, not a motion to interpolate
+    body_set_centroid(loose, (vector_t) {10, 10});
+    assert(vec_equal(body_get_interpolated_centroid(loose, 0.5), (vector_t) {10, 10}));
+
+    body_store_free(store);
+    body_free(stored);
+    body_free(loose);
+}
+
+void test_body_init_with_shape() {
+    vector_t points[] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+    polygon_t shape = {.points = points, .size = sizeof(points) / sizeof(points[0])};
+    body_t *body = body_init_with_shape(&shape, 1, (rgb_color_t) {0, 0, 0}, NULL, NULL);
+    assert(vec_equal(body_get_centroid(body), VEC_ZERO));
+    assert(body_get_shape_kind(body) == SHAPE_AABB);
+
+    // the body moves the shape it was given, rather than a copy
+    body_set_centroid(body, (vector_t) {5, 0});
+    size_t num_points;
+    const vector_t *peeked = body_peek_shape(body, &num_points);
+    assert(peeked == points && num_points == 4);
+    assert(vec_isclose(points[0], (vector_t) {4, -1}));
+
+    // and leaves it alone when freed
+    body_free(body);
+    assert(vec_isclose(points[2], (vector_t) {6, 1}));
+}
+
+void test_body_image_owner() {
+    body_t *body = body_init(make_square(), 1, (rgb_color_t) {0, 0, 0});
+    image_t *first = image_init("images/virus.png", VEC_ZERO, (vector_t) {1, 1}, IMG_INIT_PNG);
+    image_t *second = image_init("images/virus.png", VEC_ZERO, (vector_t) {1, 1}, IMG_INIT_PNG);
+    assert(first->owner == NULL);
+
+    // the renderer draws an image where its owner is drawn
+    body_set_image(body, first);
+    assert(first->owner == body);
+    body_set_image(body, second);
+    assert(first->owner == NULL && second->owner == body);
+
+    // the image outlives the body, so it forgets it
+    body_free(body);
+    assert(second->owner == NULL && image_is_removed(second));
+    image_free(first);
+    image_free(second);
+}
+
+void test_body_handles() {
+    size_t initial_count = body_count();
+    assert(body_from_handle(BODY_HANDLE_NONE) == NULL);
+
+    body_t *first = body_init(make_square(), 1, (rgb_color_t) {0, 0, 0});
+    body_handle_t first_handle = body_get_handle(first);
+    assert(body_from_handle(first_handle) == first);
+    assert(body_count() == initial_count + 1);
+
+    body_free(first);
+    assert(body_from_handle(first_handle) == NULL);
+    assert(body_count() == initial_count);
+
+    // the freed slot is reused, but the old handle still doesn't resolve
+    body_t *second = body_init(make_square(), 1, (rgb_color_t) {0, 0, 0});
+    body_handle_t second_handle = body_get_handle(second);
+    assert(second_handle.index == first_handle.index);
+    assert(second_handle.generation != first_handle.generation);
+    assert(body_from_handle(second_handle) == second);
+    assert(body_from_handle(first_handle) == NULL);
+
+    // churning bodies keeps reusing the same slot
+    body_t *temporary = body_init(make_square(), 1, (rgb_color_t) {0, 0, 0});
+    uint32_t reused_index = body_get_handle(temporary).index;
+    body_free(temporary);
+    for (size_t i = 0; i < 1000; i++) {
+        temporary = body_init(make_square(), 1, (rgb_color_t) {0, 0, 0});
+        assert(body_get_handle(temporary).index == reused_index);
+        body_free(temporary);
+    }
+    assert(body_from_handle(second_handle) == second);
+    body_free(second);
+    assert(body_count() == initial_count);
+}
+
+void test_body_store() {
+    const size_t NUM_BODIES = 50;
+    const double DT = 1e-3;
+    body_store_t *store = body_store_init();
+    body_t *stored[NUM_BODIES];
+    body_t *loose[NUM_BODIES];
+    for (size_t i = 0; i < NUM_BODIES; i++) {
+        stored[i] = body_init(make_square(), i + 1, (rgb_color_t) {0, 0, 0});
+        loose[i] = body_init(make_square(), i + 1, (rgb_color_t) {0, 0, 0});
+        body_set_velocity(stored[i], (vector_t) {i, -1.0 * i});
+        body_set_velocity(loose[i], (vector_t) {i, -1.0 * i});
+        body_store_add(store, stored[i]);
+    }
+    body_set_mass(stored[0], INFINITY);
+    body_set_mass(loose[0], INFINITY);
+
+    // removing a body moves another into its slot, handles stay valid
+    body_store_remove(store, stored[10]);
+    for (int step = 0; step < 100; step++) {
+        for (size_t i = 0; i < NUM_BODIES; i++) {
+            vector_t force = {step, i};
+            body_add_force(stored[i], force);
+            body_add_force(loose[i], force);
+            body_add_impulse(stored[i], (vector_t) {1, 1});
+            body_add_impulse(loose[i], (vector_t) {1, 1});
+        }
+        body_store_tick(store, DT);
+        body_tick(stored[10], DT);
+        for (size_t i = 0; i < NUM_BODIES; i++) {
+            body_tick(loose[i], DT);
+        }
+    }
+
+    for (size_t i = 0; i < NUM_BODIES; i++) {
+        assert(vec_isclose(body_get_centroid(stored[i]), body_get_centroid(loose[i])));
+        assert(vec_isclose(body_get_velocity(stored[i]), body_get_velocity(loose[i])));
+        size_t num_points;
+        const vector_t *points = body_peek_shape(stored[i], &num_points);
+        assert(num_points == 4);
+        assert(vec_isclose(points[0], vec_add((vector_t) {-1, -1}, body_get_centroid(loose[i]))));
+    }
+    assert(vec_equal(body_get_centroid(stored[0]), VEC_ZERO));
+
+    body_store_free(store);
+    for (size_t i = 0; i < NUM_BODIES; i++) {
+        assert(vec_isclose(body_get_centroid(stored[i]), body_get_centroid(loose[i])));
+        body_free(stored[i]);
+        body_free(loose[i]);
+    }
+}
+
 void test_infinite_mass() {
     list_t *shape = list_init(10, free);
     vector_t *v = malloc(sizeof(*v));
@@ -203,6 +398,9 @@ void test_body_info() {
     *info = 123;
     body_t *body = body_init_with_info(shape, 1, (rgb_color_t) {0, 0, 0}, info, NULL);
     assert(*(int *) body_get_info(body) == 123);
+    assert(body_get_type(body) == 0);
+    body_set_type(body, 5);
+    assert(body_get_type(body) == 5);
     body_free(body);
     free(info);
 }
@@ -251,8 +449,14 @@ int main(int argc, char *argv[]) {
     }
 
     DO_TEST(test_body_init)
+    DO_TEST(test_body_init_with_shape)
+    DO_TEST(test_body_peek_shape)
     DO_TEST(test_body_setters)
     DO_TEST(test_body_tick)
+    DO_TEST(test_body_store)
+    DO_TEST(test_body_interpolated_centroid)
+    DO_TEST(test_body_image_owner)
+    DO_TEST(test_body_handles)
     DO_TEST(test_infinite_mass)
     DO_TEST(test_forces)
     DO_TEST(test_body_remove)
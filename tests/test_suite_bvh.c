@@ -0,0 +1,159 @@
+#include "bvh.h"
+#include "polygon.h"
+#include "test_util.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+body_t *make_square(vector_t center, double half_side) {
+    list_t *shape = polygon_make_rectangle(center.x - half_side, center.y - half_side,
+                                           center.x + half_side, center.y + half_side);
+    return body_init(shape, INFINITY, (rgb_color_t) {0, 0, 0});
+}
+
+bool list_contains(list_t *list, void *item) {
+    for (size_t i = 0; i < list_size(list); i++) {
+        if (list_get(list, i) == item) return true;
+    }
+    return false;
+}
+
+void test_empty_tree() {
+    bvh_t *bvh = bvh_init();
+    list_t *bodies = list_init(1, NULL);
+    bvh_build(bvh, bodies);
+    list_t *results = list_init(1, NULL);
+    bvh_query_circle(bvh, VEC_ZERO, 100, results);
+    assert(list_size(results) == 0);
+    assert(bvh_bodies(bvh) == 0);
+    list_free(results);
+    list_free(bodies);
+    bvh_free(bvh);
+}
+
+void test_point_queries() {
+    bvh_t *bvh = bvh_init();
+    list_t *bodies = list_init(3, (free_func_t) body_free);
+    body_t *left = make_square((vector_t) {0, 0}, 1);
+    body_t *right = make_square((vector_t) {10, 0}, 1);
+    body_t *big = make_square((vector_t) {5, 0}, 6);
+    list_add(bodies, left);
+    list_add(bodies, right);
+    list_add(bodies, big);
+    bvh_build(bvh, bodies);
+    assert(bvh_bodies(bvh) == 3);
+
+    list_t *results = list_init(3, NULL);
+    bvh_query_circle(bvh, (vector_t) {0.5, 0.5}, 0, results);
+    assert(list_size(results) == 2);
+    assert(list_contains(results, left) && list_contains(results, big));
+    list_free(results);
+
+    results = list_init(3, NULL);
+    bvh_query_circle(bvh, (vector_t) {5, 8}, 0, results);
+    assert(list_size(results) == 0);
+    // the top of big is at y = 6
+    bvh_query_circle(bvh, (vector_t) {5, 8}, 2, results);
+    assert(list_size(results) == 1 && list_get(results, 0) == big);
+    list_free(results);
+
+    list_free(bodies);
+    bvh_free(bvh);
+}
+
+// checks that queries find the same bodies as checking every one of them
+void check_queries(bvh_t *bvh, list_t *bodies, size_t num_queries) {
+    for (size_t q = 0; q < num_queries; q++) {
+        vector_t center = {rand() % 1000, rand() % 500};
+        double radius = rand() % 40;
+        list_t *results = list_init(4, NULL);
+        bvh_query_circle(bvh, center, radius, results);
+        size_t expected = 0;
+        for (size_t i = 0; i < list_size(bodies); i++) {
+            body_t *body = list_get(bodies, i);
+            size_t size;
+            const vector_t *points = body_peek_shape(body, &size);
+            // points[0] is the lower left corner and points[2] the upper right
+            double dx = fmax(0, fmax(points[0].x - center.x, center.x - points[2].x));
+            double dy = fmax(0, fmax(points[0].y - center.y, center.y - points[2].y));
+            bool near = dx * dx + dy * dy <= radius * radius;
+            assert(list_contains(results, body) == near);
+            expected += near;
+        }
+        assert(list_size(results) == expected);
+        list_free(results);
+    }
+}
+
+list_t *make_random_squares(size_t num_bodies) {
+    list_t *bodies = list_init(num_bodies, (free_func_t) body_free);
+    for (size_t i = 0; i < num_bodies; i++) {
+        vector_t center = {rand() % 1000, rand() % 500};
+        list_add(bodies, make_square(center, 1 + rand() % 20));
+    }
+    return bodies;
+}
+
+// a tree of many bodies finds the same bodies as checking every one of them
+void test_matches_brute_force() {
+    bvh_t *bvh = bvh_init();
+    srand(1);
+    list_t *bodies = make_random_squares(500);
+    // building twice reuses the storage and gives the same answers
+    bvh_build(bvh, bodies);
+    bvh_build(bvh, bodies);
+    check_queries(bvh, bodies, 200);
+    list_free(bodies);
+    bvh_free(bvh);
+}
+
+void test_refit() {
+    bvh_t *bvh = bvh_init();
+    srand(2);
+    list_t *bodies = make_random_squares(500);
+    bvh_build(bvh, bodies);
+
+    // move some bodies a long way and refit only them
+    for (size_t i = 0; i < 50; i++) {
+        body_t *body = list_get(bodies, rand() % list_size(bodies));
+        body_set_centroid(body, (vector_t) {rand() % 1000, rand() % 500});
+        assert(bvh_refit(bvh, body));
+    }
+    check_queries(bvh, bodies, 200);
+
+    body_t *outside = make_square(VEC_ZERO, 1);
+    assert(!bvh_refit(bvh, outside));
+    body_free(outside);
+
+    // rebuilding with fewer bodies forgets the ones left out
+    list_t *half = list_init(list_size(bodies) / 2, NULL);
+    for (size_t i = 0; i < list_size(bodies) / 2; i++) {
+        list_add(half, list_get(bodies, i));
+    }
+    bvh_build(bvh, half);
+    assert(!bvh_refit(bvh, list_get(bodies, list_size(bodies) - 1)));
+    body_t *kept = list_get(half, 10);
+    body_set_centroid(kept, (vector_t) {900, 450});
+    assert(bvh_refit(bvh, kept));
+    check_queries(bvh, half, 200);
+    list_free(half);
+    list_free(bodies);
+    bvh_free(bvh);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_empty_tree)
+    DO_TEST(test_point_queries)
+    DO_TEST(test_matches_brute_force)
+    DO_TEST(test_refit)
+
+    puts("bvh_test PASS");
+}
@@ -8,6 +8,7 @@
 #include "vector.h"
 #include "collision.h"
 #include "body.h"
+#include "polygon.h"
 
 // body_t* make_squre_with_side_length(double side_length)
 // {
@@ -62,6 +63,182 @@
 //     body_free(b2);
 // }
 
+body_t *make_circle_body(vector_t center, double radius, size_t num_points)
+{
+    return body_init(polygon_make_circle(center, radius, num_points), 1, (rgb_color_t){0, 0, 0});
+}
+
+body_t *make_box_body(vector_t center, double half_width, double half_height)
+{
+    list_t *shape = polygon_make_rectangle(center.x - half_width, center.y - half_height,
+                                           center.x + half_width, center.y + half_height);
+    return body_init(shape, 1, (rgb_color_t){0, 0, 0});
+}
+
+void test_shape_kinds()
+{
+    body_t *circle = make_circle_body((vector_t){10, 20}, 5, 10);
+    assert(body_get_shape_kind(circle) == SHAPE_CIRCLE);
+    assert(isclose(body_get_radius(circle), 5));
+    body_t *pentagon = make_circle_body((vector_t){0, 0}, 3, 5);
+    assert(body_get_shape_kind(pentagon) == SHAPE_CIRCLE);
+    body_t *box = make_box_body((vector_t){1, 2}, 3, 4);
+    assert(body_get_shape_kind(box) == SHAPE_AABB);
+    assert(vec_isclose(body_get_half_extents(box), (vector_t){3, 4}));
+    body_t *star = body_init(polygon_make_star((vector_t){0, 0}, 10, 5), 1, (rgb_color_t){0, 0, 0});
+    assert(body_get_shape_kind(star) == SHAPE_POLYGON);
+
+    // a box turned a quarter is still axis-aligned, but not at an eighth
+    body_set_rotation(box, M_PI / 2);
+    assert(body_get_shape_kind(box) == SHAPE_AABB);
+    assert(vec_isclose(body_get_half_extents(box), (vector_t){4, 3}));
+    body_set_rotation(box, M_PI / 4);
+    assert(body_get_shape_kind(box) == SHAPE_POLYGON);
+    body_set_rotation(circle, 1);
+    assert(body_get_shape_kind(circle) == SHAPE_CIRCLE);
+
+    body_free(circle);
+    body_free(pentagon);
+    body_free(box);
+    body_free(star);
+}
+
+void test_circle_collisions()
+{
+    body_t *a = make_circle_body((vector_t){0, 0}, 5, 10);
+    body_t *b = make_circle_body((vector_t){8, 6}, 6, 10);
+    collision_info_t collision = find_body_collision(a, b);
+    assert(collision.collided);
+    assert(vec_isclose(collision.axis, (vector_t){0.8, 0.6}));
+    collision = find_body_collision(b, a);
+    assert(collision.collided);
+    assert(vec_isclose(collision.axis, (vector_t){-0.8, -0.6}));
+
+    body_set_centroid(b, (vector_t){9, 8});
+    assert(!find_body_collision(a, b).collided);
+    body_free(a);
+    body_free(b);
+}
+
+void test_circle_box_collisions()
+{
+    body_t *box = make_box_body((vector_t){0, 0}, 10, 2);
+    body_t *circle = make_circle_body((vector_t){5, 4}, 3, 10);
+    collision_info_t collision = find_body_collision(circle, box);
+    assert(collision.collided);
+    assert(vec_isclose(collision.axis, (vector_t){0, -1}));
+    collision = find_body_collision(box, circle);
+    assert(collision.collided);
+    assert(vec_isclose(collision.axis, (vector_t){0, 1}));
+
+    // near a corner, the closest point is the corner itself
+    body_set_centroid(circle, (vector_t){12, 4});
+    collision = find_body_collision(circle, box);
+    assert(collision.collided);
+    assert(vec_isclose(collision.axis, vec_unit((vector_t){-2, -2})));
+    body_set_centroid(circle, (vector_t){13, 5});
+    assert(!find_body_collision(circle, box).collided);
+
+    // with the center inside, the circle is pushed out the nearest side
+    body_set_centroid(circle, (vector_t){9, 0.5});
+    collision = find_body_collision(circle, box);
+    assert(collision.collided);
+    assert(vec_isclose(collision.axis, (vector_t){-1, 0}));
+    body_free(box);
+    body_free(circle);
+}
+
+void test_box_collisions()
+{
+    body_t *a = make_box_body((vector_t){0, 0}, 5, 5);
+    body_t *b = make_box_body((vector_t){9, -2}, 5, 5);
+    collision_info_t collision = find_body_collision(a, b);
+    assert(collision.collided);
+    assert(vec_isclose(collision.axis, (vector_t){1, 0}));
+    collision = find_body_collision(b, a);
+    assert(vec_isclose(collision.axis, (vector_t){-1, 0}));
+
+    body_set_centroid(b, (vector_t){-2, 9});
+    collision = find_body_collision(a, b);
+    assert(collision.collided);
+    assert(vec_isclose(collision.axis, (vector_t){0, 1}));
+
+    body_set_centroid(b, (vector_t){11, 0});
+    assert(!find_body_collision(a, b).collided);
+    body_free(a);
+    body_free(b);
+}
+
+// closed-form answers agree with SAT on the same vertices away from the edge cases
+void test_matches_polygon_collision()
+{
+    body_t *box = make_box_body((vector_t){0, 0}, 10, 2);
+    body_t *circle = make_circle_body((vector_t){0, 0}, 3, 40);
+    vector_t positions[] = {{0, 4}, {0, 6}, {-14, 0}, {-11, 0}, {20, 20}, {5, -4.5}};
+    for (size_t i = 0; i < sizeof(positions) / sizeof(positions[0]); i++)
+    {
+        body_set_centroid(circle, positions[i]);
+        size_t size1;
+        size_t size2;
+        const vector_t *shape1 = body_peek_shape(circle, &size1);
+        const vector_t *shape2 = body_peek_shape(box, &size2);
+        collision_info_t expected = find_collision_points(shape1, size1, shape2, size2);
+        assert(find_body_collision(circle, box).collided == expected.collided);
+    }
+    body_free(box);
+    body_free(circle);
+}
+
+// the SIMD projections must give bit-for-bit the same answers as the scalar ones
+void test_simd_matches_scalar()
+{
+    rgb_color_t black = {0, 0, 0};
+    body_t *bodies[] = {
+        make_circle_body((vector_t){0, 0}, 3, 5),
+        make_circle_body((vector_t){0, 0}, 5, 10),
+        make_circle_body((vector_t){0, 0}, 4, 40),
+        make_box_body((vector_t){0, 0}, 10, 2),
+        make_box_body((vector_t){0, 0}, 3, 7),
+        body_init(polygon_make_star((vector_t){0, 0}, 10, 5), 1, black),
+        body_init(polygon_make_star((vector_t){0, 0}, 6, 8), 1, black),
+    };
+    size_t num_bodies = sizeof(bodies) / sizeof(bodies[0]);
+    body_set_rotation(bodies[4], 0.3);
+    body_set_rotation(bodies[6], 1.1);
+
+    size_t collisions = 0;
+    for (size_t i = 0; i < num_bodies; i++)
+    {
+        for (size_t j = 0; j < num_bodies; j++)
+        {
+            for (double x = -20; x <= 20; x += 1.5)
+            {
+                for (double y = -20; y <= 20; y += 1.5)
+                {
+                    body_set_centroid(bodies[j], (vector_t){x, y});
+                    size_t size1;
+                    size_t size2;
+                    const vector_t *shape1 = body_peek_shape(bodies[i], &size1);
+                    const vector_t *shape2 = body_peek_shape(bodies[j], &size2);
+                    collision_info_t simd = find_collision_points(shape1, size1, shape2, size2);
+                    collision_info_t scalar = find_collision_points_scalar(shape1, size1, shape2, size2);
+                    assert(simd.collided == scalar.collided);
+                    assert(simd.axis.x == scalar.axis.x && simd.axis.y == scalar.axis.y);
+                    collisions += simd.collided;
+                }
+            }
+            body_set_centroid(bodies[j], VEC_ZERO);
+        }
+    }
+    // both outcomes were covered
+    assert(collisions > 0 && collisions < num_bodies * num_bodies * 27 * 27);
+
+    for (size_t i = 0; i < num_bodies; i++)
+    {
+        body_free(bodies[i]);
+    }
+}
+
 int main(int argc, char *argv[])
 {
     // Run all tests? True if there are no command-line arguments
@@ -76,6 +253,12 @@ int main(int argc, char *argv[])
 
     // DO_TEST(sanity_test_collision);
     // DO_TEST(test_collisions);
+    DO_TEST(test_shape_kinds)
+    DO_TEST(test_circle_collisions)
+    DO_TEST(test_circle_box_collisions)
+    DO_TEST(test_box_collisions)
+    DO_TEST(test_matches_polygon_collision)
+    DO_TEST(test_simd_matches_scalar)
 
-    puts("collision_tests nothing PASS");
+    puts("collision_test PASS");
 }
@@ -319,6 +319,35 @@ void test_null_values()
     list_free(l);
 }
 
+bool is_odd(size_t *value)
+{
+    return *value % 2 == 1;
+}
+
+void test_list_remove_if()
+{
+    list_t *l = list_init(1, free);
+    assert(list_remove_if(l, (list_predicate_t)is_odd) == 0);
+    for (size_t i = 0; i < LARGE_SIZE; i++)
+    {
+        size_t *value = malloc(sizeof(*value));
+        *value = i;
+        list_add(l, value);
+    }
+
+    // odd values are freed, even values keep their order
+    assert(list_remove_if(l, (list_predicate_t)is_odd) == LARGE_SIZE / 2);
+    assert(list_size(l) == LARGE_SIZE / 2);
+    for (size_t i = 0; i < list_size(l); i++)
+    {
+        assert(*(size_t *)list_get(l, i) == 2 * i);
+    }
+    assert(list_remove_if(l, (list_predicate_t)is_odd) == 0);
+    assert(list_size(l) == LARGE_SIZE / 2);
+
+    list_free(l);
+}
+
 int main(int argc, char *argv[])
 {
     // Run all tests if there are no command-line arguments
@@ -340,6 +369,7 @@ int main(int argc, char *argv[])
     DO_TEST(test_full_add)
     DO_TEST(test_empty_remove)
     DO_TEST(test_null_values)
+    DO_TEST(test_list_remove_if)
 
     puts("list_test PASS");
 }
\ No newline at end of file
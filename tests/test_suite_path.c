@@ -1,4 +1,119 @@
+#include "path.h"
+#include "virus.h"
+#include "test_util.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
 
-int main() {
-    return 1;
-}
\ No newline at end of file
+// an L: 10 to the right, then 5 up, with a repeated point
+path_t *make_corner_path() {
+    vector_t points[] = {{0, 0}, {10, 0}, {10, 0}, {10, 5}};
+    return path_init(points, sizeof(points) / sizeof(points[0]));
+}
+
+void test_positions() {
+    path_t *path = make_corner_path();
+    assert(isclose(path_get_length(path), 15));
+
+    assert(vec_isclose(path_get_position(path, 0), (vector_t){0, 0}));
+    assert(vec_isclose(path_get_position(path, 4), (vector_t){4, 0}));
+    assert(vec_isclose(path_get_position(path, 10), (vector_t){10, 0}));
+    assert(vec_isclose(path_get_position(path, 12), (vector_t){10, 2}));
+    assert(vec_isclose(path_get_position(path, 15), (vector_t){10, 5}));
+    // the first and last segments carry on past the ends
+    assert(vec_isclose(path_get_position(path, -3), (vector_t){-3, 0}));
+    assert(vec_isclose(path_get_position(path, 17), (vector_t){10, 7}));
+
+    assert(vec_isclose(path_get_direction(path, -3), (vector_t){1, 0}));
+    assert(vec_isclose(path_get_direction(path, 4), (vector_t){1, 0}));
+    assert(vec_isclose(path_get_direction(path, 10), (vector_t){0, 1}));
+    assert(vec_isclose(path_get_direction(path, 17), (vector_t){0, 1}));
+    path_free(path);
+}
+
+void test_progress() {
+    path_t *path = make_corner_path();
+    assert(isclose(path_get_progress(path, (vector_t){4, 0}), 4));
+    assert(isclose(path_get_progress(path, (vector_t){4, 2}), 4));
+    assert(isclose(path_get_progress(path, (vector_t){12, 3}), 13));
+    assert(isclose(path_get_progress(path, (vector_t){11, -1}), 10));
+    assert(isclose(path_get_progress(path, (vector_t){-5, 1}), -5));
+    assert(isclose(path_get_progress(path, (vector_t){10, 9}), 19));
+    for (double progress = -5; progress < 20; progress += 0.5) {
+        assert(isclose(path_get_progress(path, path_get_position(path, progress)), progress));
+    }
+    path_free(path);
+}
+
+void test_create_path() {
+    scene_t *scene = scene_init();
+    // outer edge then inner edge, 20 wide, turning up after 100
+    list_t *vertices = list_init(6, free);
+    list_add(vertices, vec_init(0, 0));
+    list_add(vertices, vec_init(100, 0));
+    list_add(vertices, vec_init(100, 100));
+    list_add(vertices, vec_init(80, 100));
+    list_add(vertices, vec_init(80, 20));
+    list_add(vertices, vec_init(0, 20));
+    body_t *body = create_path(scene, vertices);
+    assert(get_global_type(body) == PATH_TYPE);
+    assert(scene_bodies(scene) == 1);
+
+    // the center line runs down the middle
+    path_t *path = get_global_secondary_info(body);
+    assert(isclose(path_get_length(path), 180));
+    assert(vec_isclose(path_get_position(path, 0), (vector_t){0, 10}));
+    assert(vec_isclose(path_get_position(path, 90), (vector_t){90, 10}));
+    assert(vec_isclose(path_get_position(path, 180), (vector_t){90, 100}));
+    scene_free(scene);
+}
+
+void test_virus_follows_path() {
+    scene_t *scene = scene_init();
+    path_t *path = make_corner_path();
+    game_state_t game_state = {.scene = scene, .path = path};
+    double dt = 0.01;
+
+    // put on the path, heading along it
+    body_t *virus_body = create_virus(scene, 1, (vector_t){0, -2}, (vector_t){2, 1}, &game_state, false);
+    virus_t *virus = get_global_secondary_info(virus_body);
+    assert(isclose(virus_get_progress(virus), 2));
+    assert(vec_isclose(body_get_centroid(virus_body), (vector_t){2, 0}));
+    assert(vec_isclose(body_get_velocity(virus_body), (vector_t){2, 0}));
+
+    // around the corner, staying on the path
+    for (size_t i = 0; i < 500; i++) {
+        virus_tick(virus_body, path, dt);
+        assert(vec_isclose(body_get_centroid(virus_body), path_get_position(path, virus_get_progress(virus))));
+        scene_tick(scene, dt);
+    }
+    assert(isclose(virus_get_progress(virus), 12));
+    assert(vec_isclose(body_get_velocity(virus_body), (vector_t){0, 2}));
+
+    // pushing back on the body slows it down along the path
+    body_add_force(virus_body, (vector_t){0, -body_get_mass(virus_body) / dt});
+    scene_tick(scene, dt);
+    virus_tick(virus_body, path, dt);
+    assert(isclose(virus_get_progress(virus), 12.01));
+    assert(vec_isclose(body_get_velocity(virus_body), (vector_t){0, 1}));
+
+    scene_free(scene);
+    path_free(path);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_positions)
+    DO_TEST(test_progress)
+    DO_TEST(test_create_path)
+    DO_TEST(test_virus_follows_path)
+
+    puts("path_test PASS");
+}
@@ -235,6 +235,46 @@ void test_weird_rotate()
     list_free(w);
 }
 
+void test_packed_polygon()
+{
+    list_t *sq = make_square();
+    polygon_t *packed = polygon_from_list(sq);
+    assert(packed->size == 4);
+    assert(isclose(polygon_packed_area(packed), 4));
+    assert(vec_isclose(polygon_packed_centroid(packed), VEC_ZERO));
+    assert(isclose(polygon_packed_max_distance_across(packed), sqrt(2)));
+
+    polygon_packed_translate(packed, (vector_t){2, 3});
+    polygon_translate(sq, (vector_t){2, 3});
+    polygon_packed_rotate(packed, 0.25 * M_PI, (vector_t){2, 3});
+    polygon_rotate(sq, 0.25 * M_PI, (vector_t){2, 3});
+    for (size_t i = 0; i < packed->size; i++)
+    {
+        assert(vec_isclose(packed->points[i], *(vector_t *)list_get(sq, i)));
+    }
+
+    list_t *copy = polygon_to_list(packed);
+    assert(list_size(copy) == 4);
+    assert(vec_isclose(*(vector_t *)list_get(copy, 0), (vector_t){2, 3 + sqrt(2)}));
+    list_free(copy);
+    polygon_free(packed);
+    list_free(sq);
+}
+
+void test_fill_circle()
+{
+    const size_t NUM_POINTS = 5;
+    vector_t points[5];
+    polygon_fill_circle(points, (vector_t){3, 4}, 7.5, NUM_POINTS);
+    list_t *circle = polygon_make_circle((vector_t){3, 4}, 7.5, NUM_POINTS);
+    assert(list_size(circle) == NUM_POINTS);
+    for (size_t i = 0; i < NUM_POINTS; i++)
+    {
+        assert(vec_equal(points[i], *(vector_t *)list_get(circle, i)));
+    }
+    list_free(circle);
+}
+
 int main(int argc, char *argv[])
 {
     // Run all tests? True if there are no command-line arguments
@@ -258,6 +298,8 @@ int main(int argc, char *argv[])
     DO_TEST(test_weird_area_centroid)
     DO_TEST(test_weird_translate)
     DO_TEST(test_weird_rotate)
+    DO_TEST(test_packed_polygon)
+    DO_TEST(test_fill_circle)
 
     puts("polygon_test PASS");
 }
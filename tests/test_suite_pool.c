@@ -0,0 +1,96 @@
+#include "pool.h"
+#include "test_util.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    double x;
+    char name[20];
+} thing_t;
+
+void test_alloc_release() {
+    pool_t *pool = pool_init(sizeof(thing_t), 4);
+    assert(pool_live(pool) == 0);
+    assert(pool_capacity(pool) == 0);
+
+    thing_t *things[10];
+    for (size_t i = 0; i < 10; i++) {
+        things[i] = pool_alloc(pool);
+        // objects are aligned like malloc() results and don't overlap
+        assert((uintptr_t) things[i] % sizeof(max_align_t) == 0);
+        things[i]->x = i;
+        memset(things[i]->name, 'a' + i, sizeof(things[i]->name));
+    }
+    assert(pool_live(pool) == 10);
+    assert(pool_capacity(pool) == 12);
+    for (size_t i = 0; i < 10; i++) {
+        assert(things[i]->x == i);
+        assert(things[i]->name[sizeof(things[i]->name) - 1] == (char) ('a' + i));
+    }
+
+    // the most recently released object is reused first
+    pool_release(things[3]);
+    pool_release(things[7]);
+    assert(pool_live(pool) == 8);
+    assert(pool_alloc(pool) == things[7]);
+    assert(pool_alloc(pool) == things[3]);
+    assert(pool_capacity(pool) == 12);
+
+    pool_release(NULL);
+    pool_free(pool);
+}
+
+void test_rewind() {
+    pool_t *pool = pool_init(sizeof(thing_t), 4);
+    void *first = pool_alloc(pool);
+    void *objects[9];
+    for (size_t i = 0; i < 9; i++) {
+        objects[i] = pool_alloc(pool);
+    }
+    pool_release(first);
+    for (size_t i = 0; i < 9; i++) {
+        pool_release(objects[i]);
+    }
+    assert(pool_live(pool) == 0);
+
+    // with everything released, objects come from the first block again,
+    // and no more blocks are needed for the same number of objects
+    assert(pool_alloc(pool) == first);
+    for (size_t i = 0; i < 9; i++) {
+        assert(pool_alloc(pool) == objects[i]);
+    }
+    assert(pool_capacity(pool) == 12);
+    pool_free(pool);
+}
+
+void release_twice(void *pool) {
+    void *object = pool_alloc(pool);
+    void *other = pool_alloc(pool);
+    pool_release(object);
+    pool_release(object);
+    pool_release(other);
+}
+
+void test_double_release() {
+    pool_t *pool = pool_init(sizeof(thing_t), 4);
+    assert(test_assert_fail(release_twice, pool));
+    pool_free(pool);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_alloc_release)
+    DO_TEST(test_rewind)
+    DO_TEST(test_double_release)
+
+    puts("pool_test PASS");
+}
@@ -0,0 +1,110 @@
+#include "profile.h"
+#include "test_util.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+const char TRACE_PATH[] = "out/test_profile_trace.json";
+
+void test_zones_and_counters() {
+    profile_reset();
+    assert(profile_frames() == 0);
+    assert(profile_last_calls(PROFILE_SCENE_TICK) == 0);
+
+    profile_begin(PROFILE_SCENE_TICK);
+    for (size_t i = 0; i < 3; i++) {
+        profile_begin(PROFILE_FIND_COLLISION);
+        profile_count(PROFILE_COLLISION_TESTS, 1);
+        profile_end(PROFILE_FIND_COLLISION);
+    }
+    profile_count(PROFILE_BODIES, 7);
+    profile_end(PROFILE_SCENE_TICK);
+    profile_frame();
+
+    assert(profile_frames() == 1);
+    assert(profile_last_calls(PROFILE_SCENE_TICK) == 1);
+    assert(profile_last_calls(PROFILE_FIND_COLLISION) == 3);
+    assert(profile_last_calls(PROFILE_RENDER) == 0);
+    assert(profile_last_count(PROFILE_COLLISION_TESTS) == 3);
+    assert(profile_last_count(PROFILE_BODIES) == 7);
+    // the outer zone contains the inner ones
+    assert(profile_last_ms(PROFILE_SCENE_TICK) >= profile_last_ms(PROFILE_FIND_COLLISION));
+    assert(profile_last_ms(PROFILE_RENDER) == 0.0);
+
+    // the next frame starts empty
+    profile_frame();
+    assert(profile_frames() == 2);
+    assert(profile_last_calls(PROFILE_SCENE_TICK) == 0);
+    assert(profile_last_count(PROFILE_BODIES) == 0);
+}
+
+void test_format_zone() {
+    profile_reset();
+    profile_begin(PROFILE_RENDER);
+    profile_end(PROFILE_RENDER);
+    profile_begin(PROFILE_RENDER);
+    profile_end(PROFILE_RENDER);
+    profile_frame();
+
+    char buffer[100];
+    profile_format_zone(PROFILE_RENDER, buffer, sizeof(buffer));
+    assert(strncmp(buffer, "render ", strlen("render ")) == 0);
+    assert(strstr(buffer, " ms (2)") != NULL);
+
+    // truncated, but still terminated
+    char small[4];
+    profile_format_zone(PROFILE_RENDER, small, sizeof(small));
+    assert(strcmp(small, "ren") == 0);
+}
+
+void test_write_trace() {
+    profile_reset();
+    // more frames than the ring buffer keeps
+    for (size_t i = 0; i < 1000; i++) {
+        profile_begin(PROFILE_TOWER_TICK);
+        profile_end(PROFILE_TOWER_TICK);
+        profile_count(PROFILE_DRAW_CALLS, 2);
+        profile_frame();
+    }
+    assert(profile_frames() == 1000);
+    assert(profile_last_count(PROFILE_DRAW_CALLS) == 2);
+    assert(profile_write_trace(TRACE_PATH));
+
+    FILE *file = fopen(TRACE_PATH, "r");
+    assert(file != NULL);
+    char line[200];
+    assert(fgets(line, sizeof(line), file) != NULL);
+    assert(strcmp(line, "{\"traceEvents\":[\n") == 0);
+    size_t frames = 0;
+    size_t towers = 0;
+    size_t counters = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        frames += strstr(line, "\"name\":\"frame\"") != NULL;
+        towers += strstr(line, "\"name\":\"tower_tick\"") != NULL;
+        counters += strstr(line, "\"draw_calls\":2") != NULL;
+    }
+    fclose(file);
+    remove(TRACE_PATH);
+    assert(frames > 0 && frames < 1000);
+    assert(towers == frames);
+    assert(counters == frames);
+
+    assert(!profile_write_trace("out/no_such_directory/trace.json"));
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_zones_and_counters)
+    DO_TEST(test_format_zone)
+    DO_TEST(test_write_trace)
+
+    puts("profile_test PASS");
+}
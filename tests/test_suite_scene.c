@@ -1,4 +1,5 @@
 #include "scene.h"
+#include "global_body_info.h"
 #include "test_util.h"
 #include <assert.h>
 #include <math.h>
@@ -230,6 +231,196 @@ void test_reaping() {
     scene_free(scene);
 }
 
+/*
+    Pairs of neighboring bodies share a force creator.
+    Removing every third body should drop exactly the creators
+    that depend on it and keep the other bodies in order.
+*/
+void count_pair_calls(void *aux) {
+    (*(int *) aux)++;
+}
+
+void test_reaping_many() {
+    const size_t NUM_BODIES = 300;
+    scene_t *scene = scene_init();
+    body_t *bodies[NUM_BODIES];
+    int pair_calls[NUM_BODIES - 1];
+    for (size_t i = 0; i < NUM_BODIES; i++) {
+        bodies[i] = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+        scene_add_body(scene, bodies[i]);
+    }
+    for (size_t i = 0; i + 1 < NUM_BODIES; i++) {
+        pair_calls[i] = 0;
+        list_t *pair = list_init(2, NULL);
+        list_add(pair, bodies[i]);
+        list_add(pair, bodies[i + 1]);
+        scene_add_bodies_force_creator(scene, count_pair_calls, &pair_calls[i], pair, NULL);
+        list_free(pair);
+    }
+    scene_tick(scene, 1);
+
+    for (size_t i = 0; i < NUM_BODIES; i += 3) {
+        body_remove(bodies[i]);
+    }
+    scene_tick(scene, 1);
+    assert(scene_bodies(scene) == NUM_BODIES - NUM_BODIES / 3);
+    size_t index = 0;
+    for (size_t i = 0; i < NUM_BODIES; i++) {
+        if (i % 3 != 0) {
+            assert(scene_get_body(scene, index++) == bodies[i]);
+        }
+    }
+
+    scene_tick(scene, 1);
+    for (size_t i = 0; i + 1 < NUM_BODIES; i++) {
+        // pairs (3k, 3k + 1) and (3k + 2, 3k + 3) lost a body
+        bool survives = i % 3 == 1;
+        assert(pair_calls[i] == (survives ? 3 : 2));
+    }
+    scene_free(scene);
+}
+
+void test_static_bodies() {
+    scene_t *scene = scene_init();
+    body_t *wall = body_init(make_shape(), INFINITY, (rgb_color_t) {0, 0, 0});
+    body_t *moving = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+    scene_add_static_body(scene, wall);
+    scene_add_body(scene, moving);
+    assert(scene_bodies(scene) == 2);
+
+    // only static bodies are found
+    list_t *results = list_init(1, NULL);
+    scene_query_static(scene, (vector_t) {0, 0.5}, 0, results);
+    assert(list_size(results) == 1 && list_get(results, 0) == wall);
+    list_free(results);
+
+    body_set_centroid(wall, (vector_t) {10, 10});
+    scene_static_bodies_moved(scene);
+    results = list_init(1, NULL);
+    scene_query_static(scene, (vector_t) {0, 0.5}, 0, results);
+    assert(list_size(results) == 0);
+    scene_query_static(scene, (vector_t) {10, 10}, 0, results);
+    assert(list_size(results) == 1);
+    list_free(results);
+
+    // removed bodies aren't found, even before they are freed
+    body_remove(wall);
+    results = list_init(1, NULL);
+    scene_query_static(scene, (vector_t) {10, 10}, 0, results);
+    assert(list_size(results) == 0);
+    scene_tick(scene, 1);
+    scene_query_static(scene, (vector_t) {10, 10}, 0, results);
+    assert(list_size(results) == 0);
+    assert(scene_bodies(scene) == 1);
+    list_free(results);
+    scene_free(scene);
+}
+
+void count_collisions(body_t *body1, body_t *body2, vector_t axis, void *aux) {
+    assert(get_global_type(body1) == VIRUS_TYPE);
+    assert(get_global_type(body2) == BULLET_TYPE);
+    (*(int *) aux)++;
+}
+
+void test_collision_rule() {
+    scene_t *scene = scene_init();
+    int *count = malloc(sizeof(*count));
+    *count = 0;
+    scene_add_collision_rule(scene, VIRUS_TYPE, BULLET_TYPE, count_collisions, count, free);
+
+    body_t *bullet = body_init_with_secondary_info(make_shape(), 1, (rgb_color_t) {0, 0, 0},
+                                                   NULL, free, BULLET_TYPE);
+    body_t *virus = body_init_with_secondary_info(make_shape(), 1, (rgb_color_t) {0, 0, 0},
+                                                  NULL, free, VIRUS_TYPE);
+    body_t *other = body_init_with_secondary_info(make_shape(), 1, (rgb_color_t) {0, 0, 0},
+                                                  NULL, free, TOWER_TYPE);
+    scene_add_body(scene, bullet);
+    scene_add_body(scene, virus);
+    scene_add_body(scene, other);
+    body_set_centroid(bullet, (vector_t) {-10, 0});
+    body_set_velocity(bullet, (vector_t) {1, 0});
+
+    // the handler only fires on the tick the bodies start overlapping
+    for (int i = 0; i < 20; i++) scene_tick(scene, 1);
+    assert(*count == 1);
+
+    // after separating, overlapping again counts as a new collision
+    body_set_velocity(bullet, (vector_t) {-1, 0});
+    for (int i = 0; i < 20; i++) scene_tick(scene, 1);
+    assert(*count == 2);
+
+    body_remove(bullet);
+    scene_tick(scene, 1);
+    assert(scene_bodies(scene) == 2);
+    assert(*count == 2);
+    scene_free(scene);
+}
+
+void test_collision_rule_registered_once() {
+    scene_t *scene = scene_init();
+    int *count = malloc(sizeof(*count));
+    *count = 0;
+    scene_add_collision_rule(scene, VIRUS_TYPE, BULLET_TYPE, count_collisions, count, NULL);
+    scene_add_collision_rule(scene, VIRUS_TYPE, BULLET_TYPE, count_collisions, count, NULL);
+
+    for (int round = 1; round <= 3; round++) {
+        body_t *bullet = body_init_with_secondary_info(make_shape(), 1, (rgb_color_t) {0, 0, 0},
+                                                       NULL, free, BULLET_TYPE);
+        body_t *virus = body_init_with_secondary_info(make_shape(), 1, (rgb_color_t) {0, 0, 0},
+                                                      NULL, free, VIRUS_TYPE);
+        scene_add_body(scene, bullet);
+        scene_add_body(scene, virus);
+        scene_tick(scene, 1);
+        // one call per collision, however many times the rule was registered
+        assert(*count == round);
+
+        // rules outlive scene_clear(), and registering them again is harmless
+        scene_clear(scene);
+        assert(scene_bodies(scene) == 0);
+        scene_add_collision_rule(scene, VIRUS_TYPE, BULLET_TYPE, count_collisions, count, NULL);
+    }
+    scene_free(scene);
+    free(count);
+}
+
+void test_bodies_of_type() {
+    scene_t *scene = scene_init();
+    body_t *untyped = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+    scene_add_body(scene, untyped);
+    body_t *viruses[3];
+    for (size_t i = 0; i < 3; i++) {
+        viruses[i] = body_init_with_secondary_info(make_shape(), 1, (rgb_color_t) {0, 0, 0},
+                                                   NULL, free, VIRUS_TYPE);
+        scene_add_body(scene, viruses[i]);
+    }
+    body_t *tower = body_init_with_secondary_info(make_shape(), 1, (rgb_color_t) {0, 0, 0},
+                                                  NULL, free, TOWER_TYPE);
+    scene_add_static_body(scene, tower);
+
+    list_t *virus_bodies = scene_get_bodies_of_type(scene, VIRUS_TYPE);
+    assert(list_size(virus_bodies) == 3);
+    for (size_t i = 0; i < 3; i++) {
+        assert(list_get(virus_bodies, i) == viruses[i]);
+    }
+    list_t *towers = scene_get_bodies_of_type(scene, TOWER_TYPE);
+    assert(list_size(towers) == 1 && list_get(towers, 0) == tower);
+    assert(list_size(scene_get_bodies_of_type(scene, NOTHING)) == 1);
+    assert(list_size(scene_get_bodies_of_type(scene, QUIT_BUTTON_TYPE)) == 0);
+
+    // removed bodies leave their type's list when they are freed, keeping the rest in order
+    body_remove(viruses[1]);
+    assert(list_size(virus_bodies) == 3);
+    scene_tick(scene, 1);
+    assert(list_size(virus_bodies) == 2);
+    assert(list_get(virus_bodies, 0) == viruses[0] && list_get(virus_bodies, 1) == viruses[2]);
+    assert(list_size(towers) == 1);
+
+    scene_clear(scene);
+    assert(list_size(virus_bodies) == 0);
+    assert(list_size(towers) == 0);
+    scene_free(scene);
+}
+
 int main(int argc, char *argv[]) {
     // Run all tests if there are no command-line arguments
     bool all_tests = argc == 1;
@@ -244,6 +435,11 @@ int main(int argc, char *argv[]) {
     DO_TEST(test_force_creator)
     DO_TEST(test_force_creator_aux)
     DO_TEST(test_reaping)
+    DO_TEST(test_reaping_many)
+    DO_TEST(test_static_bodies)
+    DO_TEST(test_collision_rule)
+    DO_TEST(test_collision_rule_registered_once)
+    DO_TEST(test_bodies_of_type)
 
     puts("scene_test PASS");
 }
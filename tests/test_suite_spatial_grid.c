@@ -0,0 +1,157 @@
+#include "spatial_grid.h"
+#include "test_util.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+list_t *make_shape() {
+    list_t *shape = list_init(4, free);
+    vector_t *v = malloc(sizeof(*v));
+    *v = (vector_t) {-1, -1};
+    list_add(shape, v);
+    v = malloc(sizeof(*v));
+    *v = (vector_t) {+1, -1};
+    list_add(shape, v);
+    v = malloc(sizeof(*v));
+    *v = (vector_t) {+1, +1};
+    list_add(shape, v);
+    v = malloc(sizeof(*v));
+    *v = (vector_t) {-1, +1};
+    list_add(shape, v);
+    return shape;
+}
+
+typedef struct {
+    body_t *bodies[10];
+    size_t counts[10][10];
+    size_t num_bodies;
+} pair_count_t;
+
+size_t body_index(pair_count_t *pairs, body_t *body) {
+    for (size_t i = 0; i < pairs->num_bodies; i++) {
+        if (pairs->bodies[i] == body) return i;
+    }
+    assert(false);
+    return 0;
+}
+
+void count_pair(body_t *body1, body_t *body2, void *aux) {
+    pair_count_t *pairs = aux;
+    size_t i = body_index(pairs, body1);
+    size_t j = body_index(pairs, body2);
+    assert(i < j);
+    pairs->counts[i][j]++;
+}
+
+void test_empty_grid() {
+    spatial_grid_t *grid = spatial_grid_init(10);
+    spatial_grid_build(grid);
+    pair_count_t pairs = {.num_bodies = 0};
+    spatial_grid_for_each_pair(grid, count_pair, &pairs);
+    assert(spatial_grid_bodies(grid) == 0);
+    spatial_grid_free(grid);
+}
+
+void test_pairs_reported_once() {
+    // small cells so every body covers several cells
+    spatial_grid_t *grid = spatial_grid_init(0.5);
+    pair_count_t pairs = {.num_bodies = 3};
+    vector_t centroids[] = {{0, 0}, {1, 1}, {20, 20}};
+    for (size_t i = 0; i < pairs.num_bodies; i++) {
+        pairs.bodies[i] = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+        body_set_centroid(pairs.bodies[i], centroids[i]);
+        spatial_grid_insert(grid, pairs.bodies[i]);
+    }
+    spatial_grid_build(grid);
+    spatial_grid_for_each_pair(grid, count_pair, &pairs);
+    assert(spatial_grid_bodies(grid) == 3);
+    assert(pairs.counts[0][1] == 1);
+    assert(pairs.counts[0][2] == 0);
+    assert(pairs.counts[1][2] == 0);
+
+    // rebuilding after the bodies move reuses the grid
+    spatial_grid_clear(grid);
+    body_set_centroid(pairs.bodies[2], (vector_t) {-2.5, -2.5});
+    for (size_t i = 0; i < pairs.num_bodies; i++) {
+        spatial_grid_insert(grid, pairs.bodies[i]);
+    }
+    spatial_grid_build(grid);
+    spatial_grid_for_each_pair(grid, count_pair, &pairs);
+    assert(pairs.counts[0][1] == 2);
+    assert(pairs.counts[0][2] == 1);
+    assert(pairs.counts[1][2] == 0);
+
+    for (size_t i = 0; i < pairs.num_bodies; i++) {
+        body_free(pairs.bodies[i]);
+    }
+    spatial_grid_free(grid);
+}
+
+void test_negative_coordinates() {
+    spatial_grid_t *grid = spatial_grid_init(3);
+    pair_count_t pairs = {.num_bodies = 2};
+    vector_t centroids[] = {{-100, -50}, {-98.5, -51}};
+    for (size_t i = 0; i < pairs.num_bodies; i++) {
+        pairs.bodies[i] = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+        body_set_centroid(pairs.bodies[i], centroids[i]);
+        spatial_grid_insert(grid, pairs.bodies[i]);
+    }
+    spatial_grid_build(grid);
+    spatial_grid_for_each_pair(grid, count_pair, &pairs);
+    assert(pairs.counts[0][1] == 1);
+    for (size_t i = 0; i < pairs.num_bodies; i++) {
+        body_free(pairs.bodies[i]);
+    }
+    spatial_grid_free(grid);
+}
+
+void count_near(body_t *body, size_t index, void *aux) {
+    pair_count_t *near = aux;
+    assert(near->bodies[index] == body);
+    near->counts[index][0]++;
+}
+
+void test_near_reported_once() {
+    spatial_grid_t *grid = spatial_grid_init(3);
+    pair_count_t near = {.num_bodies = 5};
+    vector_t centroids[] = {{0, 0}, {4, 1}, {-6, -2}, {30, 30}, {-2, 12}};
+    for (size_t i = 0; i < near.num_bodies; i++) {
+        near.bodies[i] = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+        body_set_centroid(near.bodies[i], centroids[i]);
+        spatial_grid_insert(grid, near.bodies[i]);
+    }
+    spatial_grid_build(grid);
+
+    // bounding squares reach body_get_size() = 2 * sqrt(2) from each centroid
+    spatial_grid_for_each_near(grid, (vector_t) {1, 1}, 5, count_near, &near);
+    size_t expected[] = {1, 1, 1, 0, 0};
+    for (size_t i = 0; i < near.num_bodies; i++) {
+        assert(near.counts[i][0] == expected[i]);
+        near.counts[i][0] = 0;
+    }
+    spatial_grid_for_each_near(grid, (vector_t) {30, 30}, 0, count_near, &near);
+    assert(near.counts[3][0] == 1);
+    assert(near.counts[0][0] + near.counts[1][0] + near.counts[2][0] + near.counts[4][0] == 0);
+
+    for (size_t i = 0; i < near.num_bodies; i++) {
+        body_free(near.bodies[i]);
+    }
+    spatial_grid_free(grid);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_empty_grid)
+    DO_TEST(test_pairs_reported_once)
+    DO_TEST(test_negative_coordinates)
+    DO_TEST(test_near_reported_once)
+
+    puts("spatial_grid_test PASS");
+}
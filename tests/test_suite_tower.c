@@ -1,4 +1,131 @@
+#include "tower.h"
+#include "virus.h"
+#include "path.h"
+#include "sound.h"
+#include "test_util.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
 
-int main() {
-    return 1;
-}
\ No newline at end of file
+const vector_t TEST_VIRUS_SPEED = {100, 0};
+
+// a straight path along the x axis, so a virus's progress is its x coordinate
+path_t *make_straight_path() {
+    vector_t points[] = {{0, 0}, {1000, 0}};
+    return path_init(points, sizeof(points) / sizeof(points[0]));
+}
+
+body_t *add_virus(game_state_t *game_state, double x, bool is_super_virus) {
+    return create_virus(game_state->scene, 5, TEST_VIRUS_SPEED, (vector_t) {x, 0}, game_state, is_super_virus);
+}
+
+void test_front_virus() {
+    scene_t *scene = scene_init();
+    path_t *path = make_straight_path();
+    game_state_t game_state = {.scene = scene, .path = path};
+    body_t *middle = add_virus(&game_state, 200, false);
+    body_t *front = add_virus(&game_state, 300, false);
+    body_t *back = add_virus(&game_state, 100, false);
+    tower_index_viruses(scene);
+
+    assert(tower_get_front_virus((vector_t) {0, 0}, 1000) == front);
+    assert(tower_get_front_virus((vector_t) {100, 10}, 50) == back);
+    // both middle and front are in range
+    assert(tower_get_front_virus((vector_t) {250, 0}, 60) == front);
+    assert(tower_get_front_virus((vector_t) {200, 30}, 40) == middle);
+    assert(tower_get_front_virus((vector_t) {600, 0}, 50) == NULL);
+
+    scene_free(scene);
+    path_free(path);
+}
+
+void test_order_follows_wave() {
+    scene_t *scene = scene_init();
+    path_t *path = make_straight_path();
+    game_state_t game_state = {.scene = scene, .path = path};
+    body_t *back = add_virus(&game_state, 100, false);
+    add_virus(&game_state, 200, false);
+    body_t *front = add_virus(&game_state, 300, false);
+    tower_index_viruses(scene);
+    assert(tower_get_front_virus(VEC_ZERO, 1000) == front);
+
+    // a fast virus passes the others
+    body_set_velocity(back, (vector_t) {1000, 0});
+    virus_tick(back, path, 0.5);
+    assert(virus_get_progress(get_global_secondary_info(back)) == 600);
+    tower_index_viruses(scene);
+    assert(tower_get_front_virus(VEC_ZERO, 1000) == back);
+
+    // removed viruses are dropped once the scene frees them
+    body_remove(back);
+    scene_tick(scene, 0);
+    tower_index_viruses(scene);
+    assert(tower_get_front_virus(VEC_ZERO, 1000) == front);
+    assert(tower_get_front_virus((vector_t) {600, 0}, 50) == NULL);
+
+    // viruses added mid-wave are ordered with the rest
+    body_t *new_front = add_virus(&game_state, 400, false);
+    body_t *new_back = add_virus(&game_state, 50, false);
+    tower_index_viruses(scene);
+    assert(tower_get_front_virus(VEC_ZERO, 1000) == new_front);
+    assert(tower_get_front_virus((vector_t) {50, 0}, 10) == new_back);
+    assert(tower_get_front_virus((vector_t) {300, 0}, 10) == front);
+
+    scene_free(scene);
+    path_free(path);
+}
+
+void test_super_virus_spawns() {
+    scene_t *scene = scene_init();
+    path_t *path = make_straight_path();
+    game_state_t game_state = {.scene = scene, .path = path, .pop_sound = sound_init("sounds/pop.wav", 0)};
+    body_t *normal = add_virus(&game_state, 400, false);
+    body_t *super = add_virus(&game_state, 500, true);
+    tower_index_viruses(scene);
+    assert(tower_get_front_virus(VEC_ZERO, 1000) == super);
+
+    int health = virus_get_health(get_global_secondary_info(super));
+    virus_damage(super, 1000, &game_state);
+    assert(body_is_removed(super));
+    assert(game_state.score == health);
+    scene_tick(scene, 0);
+
+    // the spawns are on the path where the super virus was, ahead of the other virus
+    list_t *viruses = scene_get_bodies_of_type(scene, VIRUS_TYPE);
+    assert(list_size(viruses) == 1 + SUPER_VIRUS_SPAWN_COUNT);
+    for (size_t i = 0; i < list_size(viruses); i++) {
+        body_t *virus = list_get(viruses, i);
+        if (virus == normal) {
+            continue;
+        }
+        virus_t *info = get_global_secondary_info(virus);
+        assert(virus_get_health(info) == SUPER_VIRUS_SPAWN_HEALTH);
+        assert(!virus_is_super_virus(info));
+        assert(isclose(virus_get_progress(info), 500));
+        assert(vec_isclose(body_get_centroid(virus), (vector_t) {500, 0}));
+    }
+    tower_index_viruses(scene);
+    body_t *front = tower_get_front_virus(VEC_ZERO, 1000);
+    assert(front != normal && front != NULL);
+    assert(tower_get_front_virus((vector_t) {400, 0}, 10) == normal);
+
+    scene_free(scene);
+    path_free(path);
+    sound_free(game_state.pop_sound);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_front_virus)
+    DO_TEST(test_order_follows_wave)
+    DO_TEST(test_super_virus_spawns)
+
+    puts("tower_test PASS");
+}
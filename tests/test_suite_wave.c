@@ -0,0 +1,214 @@
+#include "wave.h"
+#include "test_util.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <time.h>
+#include <utime.h>
+
+const char TEST_WAVES_PATH[] = "out/test_waves.txt";
+const char TEST_PRECOMPILED_WAVES_PATH[] = "out/test_waves.bin";
+const size_t LONG_WAVE_VIRUSES = 20000;
+
+void test_load_wave() {
+    scene_t *scene = scene_init();
+    wave_table_t *waves = wave_table_init("waves.txt");
+    assert(waves != NULL);
+    game_state_t game_state = {.scene = scene, .waves = waves};
+
+    // third line of waves.txt is six health 1 viruses, six columns apart;
+    // only the first two are close enough to the start to spawn right away
+    assert(load_wave(2, scene, &game_state) == 6);
+    assert(scene_bodies(scene) == 2);
+    assert(game_state.spawner.remaining == 4);
+    assert(isclose(body_get_centroid(scene_get_body(scene, 0)).x, 85));
+    assert(isclose(body_get_centroid(scene_get_body(scene, 1)).x, -5));
+
+    // the next virus spawns once it would have moved to the start, where it would be by then
+    wave_tick(scene, &game_state, 0.5);
+    assert(scene_bodies(scene) == 2);
+    wave_tick(scene, &game_state, 0.5);
+    assert(scene_bodies(scene) == 3);
+    assert(isclose(body_get_centroid(scene_get_body(scene, 2)).x, 5));
+
+    wave_tick(scene, &game_state, 100);
+    assert(scene_bodies(scene) == 6);
+    assert(game_state.spawner.remaining == 0);
+    for (size_t i = 0; i < scene_bodies(scene); i++) {
+        assert(get_global_type(scene_get_body(scene, i)) == VIRUS_TYPE);
+    }
+
+    // waves past the end of the file are empty
+    assert(load_wave(1000, scene, &game_state) == 0);
+    wave_tick(scene, &game_state, 100);
+    assert(scene_bodies(scene) == 6);
+
+    scene_free(scene);
+    wave_table_free(waves);
+}
+
+void test_long_wave_streams() {
+    FILE *f = fopen(TEST_WAVES_PATH, "w");
+    assert(f != NULL);
+    for (size_t i = 0; i < LONG_WAVE_VIRUSES; i++) {
+        fputc(i % 2 == 0 ? 'a' : 'b', f);
+        // every other virus is boosted, so it catches up with the one before it
+        if (i % 2 == 1) {
+            fputc('9', f);
+        }
+    }
+    fclose(f);
+    wave_table_t *waves = wave_table_init(TEST_WAVES_PATH);
+    assert(waves != NULL);
+    scene_t *scene = scene_init();
+    game_state_t game_state = {.scene = scene, .waves = waves};
+
+    assert(load_wave(0, scene, &game_state) == LONG_WAVE_VIRUSES / 2 * 3);
+    assert(scene_bodies(scene) < 10);
+    // a few viruses at most a step, never the whole wave
+    double dt = 1.0 / 60;
+    for (size_t tick = 0; tick < 600; tick++) {
+        size_t before = scene_bodies(scene);
+        wave_tick(scene, &game_state, dt);
+        assert(scene_bodies(scene) - before <= 2);
+    }
+    assert(scene_bodies(scene) + game_state.spawner.remaining == LONG_WAVE_VIRUSES);
+    assert(game_state.spawner.remaining > 0);
+
+    // every virus spawned is at or past the spawn line
+    for (size_t i = 0; i < scene_bodies(scene); i++) {
+        assert(body_get_centroid(scene_get_body(scene, i)).x >= -15 - 1e-6);
+    }
+
+    scene_free(scene);
+    wave_table_free(waves);
+    remove(TEST_WAVES_PATH);
+}
+
+void test_wave_table() {
+    // a digit speeds up the virus before it, a wave longer than any line buffer, and no newline at the end
+    FILE *f = fopen(TEST_WAVES_PATH, "w");
+    assert(f != NULL);
+    fputs("a  c5 !\n\n", f);
+    for (size_t i = 0; i < LONG_WAVE_VIRUSES; i++) {
+        fputc('z', f);
+    }
+    fclose(f);
+
+    wave_table_t *waves = wave_table_init(TEST_WAVES_PATH);
+    assert(waves != NULL);
+    assert(wave_table_size(waves) == 3);
+
+    size_t num_viruses;
+    const wave_virus_t *viruses = wave_table_get(waves, 0, &num_viruses);
+    assert(num_viruses == 3);
+    assert(viruses[0].offset == 1 && viruses[0].health == 1 && viruses[0].speed_boost == 0);
+    assert(viruses[1].offset == 4 && viruses[1].health == 3 && viruses[1].speed_boost == 5);
+    assert(viruses[2].offset == 7 && viruses[2].is_super_virus);
+    assert(!viruses[1].is_super_virus);
+
+    wave_table_get(waves, 1, &num_viruses);
+    assert(num_viruses == 0);
+    viruses = wave_table_get(waves, 2, &num_viruses);
+    assert(num_viruses == LONG_WAVE_VIRUSES);
+    assert(viruses[LONG_WAVE_VIRUSES - 1].offset == LONG_WAVE_VIRUSES);
+    assert(viruses[LONG_WAVE_VIRUSES - 1].health == 26);
+    wave_table_get(waves, 3, &num_viruses);
+    assert(num_viruses == 0);
+
+    wave_table_free(waves);
+    assert(wave_table_init("out/no_such_waves.txt") == NULL);
+    remove(TEST_WAVES_PATH);
+}
+
+void test_precompiled_waves() {
+    wave_table_t *waves = wave_table_init("waves.txt");
+    assert(waves != NULL);
+    assert(wave_table_write(waves, TEST_PRECOMPILED_WAVES_PATH));
+    wave_table_t *mapped = wave_table_map(TEST_PRECOMPILED_WAVES_PATH);
+    assert(mapped != NULL);
+
+    // the mapped table is the same as the parsed one, and spawns the same viruses
+    assert(wave_table_size(mapped) == wave_table_size(waves));
+    for (size_t n = 0; n < wave_table_size(waves); n++) {
+        size_t num_parsed, num_mapped;
+        const wave_virus_t *parsed = wave_table_get(waves, n, &num_parsed);
+        const wave_virus_t *loaded = wave_table_get(mapped, n, &num_mapped);
+        assert(num_parsed == num_mapped);
+        for (size_t i = 0; i < num_parsed; i++) {
+            assert(parsed[i].offset == loaded[i].offset);
+            assert(parsed[i].health == loaded[i].health);
+            assert(parsed[i].speed_boost == loaded[i].speed_boost);
+            assert(parsed[i].is_super_virus == loaded[i].is_super_virus);
+        }
+    }
+    scene_t *scene = scene_init();
+    game_state_t game_state = {.scene = scene, .waves = mapped};
+    assert(load_wave(2, scene, &game_state) == 6);
+    wave_tick(scene, &game_state, 100);
+    assert(scene_bodies(scene) == 6);
+    scene_free(scene);
+
+    wave_table_free(mapped);
+    wave_table_free(waves);
+    remove(TEST_PRECOMPILED_WAVES_PATH);
+
+    // a text wave file isn't a precompiled table
+    assert(wave_table_map("waves.txt") == NULL);
+    assert(wave_table_map("out/no_such_waves.bin") == NULL);
+}
+
+void write_test_waves(const char *contents, time_t modified) {
+    FILE *f = fopen(TEST_WAVES_PATH, "w");
+    assert(f != NULL);
+    fputs(contents, f);
+    fclose(f);
+    struct utimbuf times = {.actime = modified, .modtime = modified};
+    assert(utime(TEST_WAVES_PATH, &times) == 0);
+}
+
+void test_load_skips_stale_table() {
+    time_t now = time(NULL);
+    write_test_waves("a\n", now - 100);
+    wave_table_t *waves = wave_table_init(TEST_WAVES_PATH);
+    assert(wave_table_write(waves, TEST_PRECOMPILED_WAVES_PATH));
+    wave_table_free(waves);
+
+    // the table is newer than the wave file, so it is used
+    write_test_waves("a\nb\n", now - 100);
+    waves = wave_table_load(TEST_WAVES_PATH, TEST_PRECOMPILED_WAVES_PATH);
+    assert(waves != NULL && wave_table_size(waves) == 1);
+    wave_table_free(waves);
+
+    // once the wave file is edited, it is parsed instead
+    write_test_waves("a\nb\n", now + 100);
+    waves = wave_table_load(TEST_WAVES_PATH, TEST_PRECOMPILED_WAVES_PATH);
+    assert(waves != NULL && wave_table_size(waves) == 2);
+    wave_table_free(waves);
+
+    // and without a table, too
+    remove(TEST_PRECOMPILED_WAVES_PATH);
+    waves = wave_table_load(TEST_WAVES_PATH, TEST_PRECOMPILED_WAVES_PATH);
+    assert(waves != NULL && wave_table_size(waves) == 2);
+    wave_table_free(waves);
+    remove(TEST_WAVES_PATH);
+    assert(wave_table_load(TEST_WAVES_PATH, TEST_PRECOMPILED_WAVES_PATH) == NULL);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_load_wave)
+    DO_TEST(test_long_wave_streams)
+    DO_TEST(test_wave_table)
+    DO_TEST(test_precompiled_waves)
+    DO_TEST(test_load_skips_stale_table)
+
+    puts("wave_test PASS");
+}